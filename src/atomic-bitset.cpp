@@ -0,0 +1,73 @@
+#include "atomic-bitset.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+atomic_bitset::atomic_bitset() = default;
+
+atomic_bitset::atomic_bitset(std::size_t size)
+    : _size(size)
+    , _words(std::make_unique<std::atomic<word_type>[]>(word_count())) {}
+
+atomic_bitset::atomic_bitset(const bitset::const_view& bits)
+    : atomic_bitset(bits.size()) {
+  for (std::size_t i = 0; i < _size; i += BITS_PER_WORD) {
+    std::size_t n = std::min(BITS_PER_WORD, _size - i);
+    _words[i / BITS_PER_WORD].store(bits.subview(i, n).begin().get_n_bits(n), std::memory_order_relaxed);
+  }
+}
+
+atomic_bitset::atomic_bitset(atomic_bitset&& other) noexcept
+    : _size(std::exchange(other._size, 0))
+    , _words(std::move(other._words)) {}
+
+atomic_bitset& atomic_bitset::operator=(atomic_bitset&& other) noexcept {
+  _size = std::exchange(other._size, 0);
+  _words = std::move(other._words);
+  return *this;
+}
+
+std::size_t atomic_bitset::size() const {
+  return _size;
+}
+
+bool atomic_bitset::empty() const {
+  return _size == 0;
+}
+
+std::size_t atomic_bitset::word_count() const {
+  return (_size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+std::size_t atomic_bitset::count(std::memory_order order) const {
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < word_count(); ++i) {
+    result += std::popcount(_words[i].load(order));
+  }
+  return result;
+}
+
+bool atomic_bitset::any(std::memory_order order) const {
+  for (std::size_t i = 0; i < word_count(); ++i) {
+    if (_words[i].load(order) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void atomic_bitset::clear(std::memory_order order) {
+  for (std::size_t i = 0; i < word_count(); ++i) {
+    _words[i].store(0, order);
+  }
+}
+
+bitset atomic_bitset::to_bitset(std::memory_order order) const {
+  bitset result(_size, false);
+  for (std::size_t i = 0; i < _size; i += BITS_PER_WORD) {
+    std::size_t n = std::min(BITS_PER_WORD, _size - i);
+    result.subview(i, n).begin().change_n_bits(_words[i / BITS_PER_WORD].load(order), n);
+  }
+  return result;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size bitset whose bits can be read and modified from many threads at
+// once without locking. Every operation on a single bit or word is atomic;
+// operations spanning the whole set (count(), to_bitset()) are not snapshots
+// and may observe concurrent changes partially. The memory order of each
+// operation defaults to sequentially consistent, as for std::atomic.
+class atomic_bitset {
+public:
+  using word_type = bitset::word_type;
+
+  static constexpr std::size_t BITS_PER_WORD = bitset::BITS_PER_WORD;
+
+  atomic_bitset();
+  explicit atomic_bitset(std::size_t size);
+  explicit atomic_bitset(const bitset::const_view& bits);
+
+  atomic_bitset(const atomic_bitset&) = delete;
+  atomic_bitset& operator=(const atomic_bitset&) = delete;
+  atomic_bitset(atomic_bitset&& other) noexcept;
+  atomic_bitset& operator=(atomic_bitset&& other) noexcept;
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t word_count() const;
+
+  bool test(std::size_t pos, std::memory_order order = std::memory_order_seq_cst) const {
+    return (word(pos).load(order) & mask(pos)) != 0;
+  }
+
+  void set(std::size_t pos, std::memory_order order = std::memory_order_seq_cst) {
+    word(pos).fetch_or(mask(pos), order);
+  }
+
+  void reset(std::size_t pos, std::memory_order order = std::memory_order_seq_cst) {
+    word(pos).fetch_and(~mask(pos), order);
+  }
+
+  // Sets (clears) the bit and returns its previous value.
+  bool test_and_set(std::size_t pos, std::memory_order order = std::memory_order_seq_cst) {
+    return (word(pos).fetch_or(mask(pos), order) & mask(pos)) != 0;
+  }
+
+  bool test_and_reset(std::size_t pos, std::memory_order order = std::memory_order_seq_cst) {
+    return (word(pos).fetch_and(~mask(pos), order) & mask(pos)) != 0;
+  }
+
+  // Word-level access; `index` counts words, bits past size() in the last
+  // word must be left clear. The fetch operations return the previous word.
+  word_type load_word(std::size_t index, std::memory_order order = std::memory_order_seq_cst) const {
+    return _words[index].load(order);
+  }
+
+  word_type fetch_or(std::size_t index, word_type bits, std::memory_order order = std::memory_order_seq_cst) {
+    return _words[index].fetch_or(bits, order);
+  }
+
+  word_type fetch_and(std::size_t index, word_type bits, std::memory_order order = std::memory_order_seq_cst) {
+    return _words[index].fetch_and(bits, order);
+  }
+
+  word_type fetch_xor(std::size_t index, word_type bits, std::memory_order order = std::memory_order_seq_cst) {
+    return _words[index].fetch_xor(bits, order);
+  }
+
+  // May fail spuriously, like compare_exchange_weak; on failure `expected`
+  // receives the current word.
+  bool compare_exchange_word(
+      std::size_t index, word_type& expected, word_type desired, std::memory_order order = std::memory_order_seq_cst
+  ) {
+    return _words[index].compare_exchange_weak(expected, desired, order);
+  }
+
+  std::size_t count(std::memory_order order = std::memory_order_seq_cst) const;
+  bool any(std::memory_order order = std::memory_order_seq_cst) const;
+
+  void clear(std::memory_order order = std::memory_order_seq_cst);
+  bitset to_bitset(std::memory_order order = std::memory_order_seq_cst) const;
+
+private:
+  std::size_t _size = 0;
+  std::unique_ptr<std::atomic<word_type>[]> _words;
+
+  std::atomic<word_type>& word(std::size_t pos) const {
+    return _words[pos / BITS_PER_WORD];
+  }
+
+  static word_type mask(std::size_t pos) {
+    return word_type(1) << (pos % BITS_PER_WORD);
+  }
+};
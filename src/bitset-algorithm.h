@@ -0,0 +1,142 @@
+#pragma once
+
+#include "bitset-iterator.h"
+#include "bitset-view.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Implementations of the algorithm overloads declared as hidden friends of
+// bitset_iterator. Every range is handled through bitset_view word operations;
+// the ones that need scratch space use a fixed buffer on the stack.
+template <typename T>
+struct bitset_algorithms {
+  using mutable_word_type = std::remove_const_t<T>;
+
+  static constexpr std::size_t BUFFER_BITS = 4096;
+
+  // Scratch bits for the algorithms that have to park part of a range.
+  class buffer {
+  public:
+    bitset_view<mutable_word_type> bits(std::size_t count) {
+      bitset_iterator<mutable_word_type> first(_words, 0);
+      return bitset_view<mutable_word_type>(first, first + static_cast<std::ptrdiff_t>(count));
+    }
+
+  private:
+    mutable_word_type _words[BUFFER_BITS / bitset_iterator<mutable_word_type>::BITS_PER_WORD] = {};
+  };
+
+  template <typename U>
+  static bitset_iterator<U> copy(bitset_iterator<T> first, bitset_iterator<T> last, bitset_iterator<U> d_first) {
+    bitset_iterator<U> d_last = d_first + (last - first);
+    bitset_view<U>(d_first, d_last).assign(bitset_view<const T>(first, last));
+    return d_last;
+  }
+
+  // A forward copy is only wrong when the destination starts inside the
+  // source; then the range is copied from the back, one buffered block at a
+  // time, so that every block is read before anything overwrites it.
+  template <typename U>
+  static bitset_iterator<U> copy_backward(bitset_iterator<T> first, bitset_iterator<T> last, bitset_iterator<U> d_last) {
+    bitset_iterator<U> d_first = d_last - (last - first);
+    if (!(bit_address(first) < bit_address(d_first) && bit_address(d_first) < bit_address(last))) {
+      copy(first, last, d_first);
+      return d_first;
+    }
+    buffer scratch;
+    while (first < last) {
+      std::ptrdiff_t num_bits = std::min(static_cast<std::ptrdiff_t>(BUFFER_BITS), last - first);
+      last -= num_bits;
+      d_last -= num_bits;
+      bitset_view<mutable_word_type> block = scratch.bits(num_bits);
+      block.assign(bitset_view<const T>(last, last + num_bits));
+      bitset_view<U>(d_last, d_last + num_bits).assign(block);
+    }
+    return d_last;
+  }
+
+  static void fill(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+    bitset_view<T> view(first, last);
+    value ? view.set() : view.reset();
+  }
+
+  template <typename U>
+  static bool equal(bitset_iterator<T> first_1, bitset_iterator<T> last_1, bitset_iterator<U> first_2) {
+    bitset_view<const U> other(first_2, first_2 + (last_1 - first_1));
+    return bitset_view<const T>(first_1, last_1) == other;
+  }
+
+  static std::ptrdiff_t count(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+    auto ones = static_cast<std::ptrdiff_t>(bitset_view<const T>(first, last).count());
+    return value ? ones : (last - first) - ones;
+  }
+
+  static bitset_iterator<T> find(bitset_iterator<T> first, bitset_iterator<T> last, bool value) {
+    bitset_view<T> view(first, last);
+    std::size_t pos = value ? view.find_first() : view.find_first_zero();
+    return pos == bitset_view<T>::npos ? last : first + static_cast<std::ptrdiff_t>(pos);
+  }
+
+  template <typename U>
+  static bitset_iterator<U> swap_ranges(bitset_iterator<T> first_1, bitset_iterator<T> last_1, bitset_iterator<U> first_2) {
+    buffer scratch;
+    while (first_1 < last_1) {
+      std::ptrdiff_t num_bits = std::min(static_cast<std::ptrdiff_t>(BUFFER_BITS), last_1 - first_1);
+      bitset_view<T> lhs(first_1, first_1 + num_bits);
+      bitset_view<U> rhs(first_2, first_2 + num_bits);
+      bitset_view<mutable_word_type> block = scratch.bits(num_bits);
+      block.assign(lhs);
+      lhs.assign(rhs);
+      rhs.assign(block);
+      first_1 += num_bits;
+      first_2 += num_bits;
+    }
+    return first_2;
+  }
+
+  // Block swaps (Gries-Mills) shrink the problem until the shorter side fits
+  // the buffer; that side is parked while the other one is shifted over it.
+  static bitset_iterator<T> rotate(bitset_iterator<T> first, bitset_iterator<T> middle, bitset_iterator<T> last) {
+    bitset_iterator<T> result = first + (last - middle);
+    while (first != middle && middle != last) {
+      std::ptrdiff_t left = middle - first;
+      std::ptrdiff_t right = last - middle;
+      if (std::min(left, right) <= static_cast<std::ptrdiff_t>(BUFFER_BITS)) {
+        buffer scratch;
+        if (left <= right) {
+          bitset_view<mutable_word_type> block = scratch.bits(left);
+          block.assign(bitset_view<const T>(first, middle));
+          copy(middle, last, first);
+          bitset_view<T>(last - left, last).assign(block);
+        } else {
+          bitset_view<mutable_word_type> block = scratch.bits(right);
+          block.assign(bitset_view<const T>(middle, last));
+          copy_backward(first, middle, last);
+          bitset_view<T>(first, first + right).assign(block);
+        }
+        break;
+      }
+      if (left <= right) {
+        swap_ranges(first, middle, middle);
+        first = middle;
+        middle += left;
+      } else {
+        swap_ranges(middle - right, middle, middle);
+        last = middle;
+        middle -= right;
+      }
+    }
+    return result;
+  }
+
+private:
+  // Position of a bit in memory, comparable across iterators over any storage.
+  template <typename U>
+  static std::uintptr_t bit_address(const bitset_iterator<U>& it) {
+    return reinterpret_cast<std::uintptr_t>(it._wordPtr + it.get_word()) * CHAR_BIT + it.get_offset();
+  }
+};
@@ -0,0 +1,458 @@
+#pragma once
+
+#include "bitset-simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+class bitset;
+
+template <typename T>
+class bitset_view;
+
+// Lazy result of `&`, `|`, `^` and `~` over bitsets and views. Nothing is
+// computed until the expression is assigned to a bitset or consumed by
+// count()/any()/all(); then every operand is read once in a single word loop.
+// An expression converts to a bitset, and to a const view of a result it
+// evaluates and keeps for as long as the expression itself lives, so it can be
+// passed wherever a bitset or a const view is expected.
+//
+// Operands that are lvalues are referenced, and rvalue bitsets are moved into
+// the expression. An expression must not outlive its lvalue operands, so
+// `auto x = a & b;` is only safe while `a` and `b` stay alive and unchanged;
+// write `bitset x = a & b;` to keep the result.
+template <typename Derived>
+class bitset_expression {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t BITS_PER_WORD = std::numeric_limits<word_type>::digits;
+  static constexpr std::size_t npos = -1;
+
+  std::size_t size() const {
+    return derived().size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  bool operator[](std::size_t index) const {
+    return (derived().word(index / BITS_PER_WORD) >> (index % BITS_PER_WORD)) & 1;
+  }
+
+  // Evaluates the expression; the view stays valid while the expression lives.
+  template <typename Bitset = bitset>
+  typename Bitset::const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return materialize<Bitset>().subview(offset, count);
+  }
+
+  template <typename Bitset = bitset>
+  operator typename Bitset::const_view() const {
+    return materialize<Bitset>().subview();
+  }
+
+  std::size_t count() const {
+    std::size_t full_words = size() / BITS_PER_WORD;
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < full_words; ++i) {
+      result += std::popcount(derived().word(i));
+    }
+    if (std::size_t tail = size() % BITS_PER_WORD; tail != 0) {
+      result += std::popcount(derived().word(full_words) & tail_mask(tail));
+    }
+    return result;
+  }
+
+  bool any() const {
+    std::size_t full_words = size() / BITS_PER_WORD;
+    for (std::size_t i = 0; i < full_words; ++i) {
+      if (derived().word(i) != 0) {
+        return true;
+      }
+    }
+    std::size_t tail = size() % BITS_PER_WORD;
+    return tail != 0 && (derived().word(full_words) & tail_mask(tail)) != 0;
+  }
+
+  bool all() const {
+    std::size_t full_words = size() / BITS_PER_WORD;
+    for (std::size_t i = 0; i < full_words; ++i) {
+      if (derived().word(i) != ~word_type(0)) {
+        return false;
+      }
+    }
+    std::size_t tail = size() % BITS_PER_WORD;
+    return tail == 0 || (derived().word(full_words) & tail_mask(tail)) == tail_mask(tail);
+  }
+
+  // Writes all words of the result to `dst`; bits past size() are unspecified.
+  void evaluate(word_type* dst) const {
+    std::size_t words = (size() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    for (std::size_t i = 0; i < words; ++i) {
+      dst[i] = derived().word(i);
+    }
+  }
+
+protected:
+  static word_type tail_mask(std::size_t bits) {
+    return (word_type(1) << bits) - 1;
+  }
+
+private:
+  // Result of the last conversion to a view, owned by the expression.
+  mutable std::shared_ptr<const void> _materialized;
+
+  const Derived& derived() const {
+    return static_cast<const Derived&>(*this);
+  }
+
+  template <typename Bitset>
+  const Bitset& materialize() const {
+    auto result = std::make_shared<const Bitset>(derived());
+    _materialized = result;
+    return *result;
+  }
+};
+
+// Counterpart of std::bit_and for `lhs & ~rhs`.
+struct bit_andnot {
+  uint64_t operator()(uint64_t lhs, uint64_t rhs) const {
+    return lhs & ~rhs;
+  }
+};
+
+// Kernel table entries computing `Operation` over runs of whole words, used by
+// binary expressions whose operands are both word-aligned. Null where the table
+// has no such kernel.
+template <typename Operation>
+struct bitset_binary_kernels {
+  static constexpr void (*bitset_kernels::*ASSIGN)(uint64_t*, const uint64_t*, std::size_t) = nullptr;
+  static constexpr std::size_t (*bitset_kernels::*COUNT)(const uint64_t*, const uint64_t*, std::size_t) = nullptr;
+  static constexpr bool (*bitset_kernels::*ANY)(const uint64_t*, const uint64_t*, std::size_t) = nullptr;
+  static constexpr bool COMMUTATIVE = false;
+};
+
+template <>
+struct bitset_binary_kernels<std::bit_and<uint64_t>> {
+  static constexpr auto ASSIGN = &bitset_kernels::bit_and;
+  static constexpr auto COUNT = &bitset_kernels::and_count;
+  static constexpr auto ANY = &bitset_kernels::and_any;
+  static constexpr bool COMMUTATIVE = true;
+};
+
+template <>
+struct bitset_binary_kernels<std::bit_or<uint64_t>> {
+  static constexpr auto ASSIGN = &bitset_kernels::bit_or;
+  static constexpr auto COUNT = &bitset_kernels::or_count;
+  static constexpr bool (*bitset_kernels::*ANY)(const uint64_t*, const uint64_t*, std::size_t) = nullptr;
+  static constexpr bool COMMUTATIVE = true;
+};
+
+template <>
+struct bitset_binary_kernels<std::bit_xor<uint64_t>> {
+  static constexpr auto ASSIGN = &bitset_kernels::bit_xor;
+  static constexpr auto COUNT = &bitset_kernels::xor_count;
+  static constexpr bool (*bitset_kernels::*ANY)(const uint64_t*, const uint64_t*, std::size_t) = nullptr;
+  static constexpr bool COMMUTATIVE = true;
+};
+
+template <>
+struct bitset_binary_kernels<bit_andnot> {
+  static constexpr auto ASSIGN = &bitset_kernels::bit_andnot;
+  static constexpr auto COUNT = &bitset_kernels::andnot_count;
+  static constexpr auto ANY = &bitset_kernels::andnot_any;
+  static constexpr bool COMMUTATIVE = false;
+};
+
+template <typename T>
+concept is_bitset_expression = std::derived_from<std::remove_cvref_t<T>, bitset_expression<std::remove_cvref_t<T>>>;
+
+template <typename T>
+struct is_bitset_view : std::false_type {};
+
+template <typename T>
+struct is_bitset_view<bitset_view<T>> : std::true_type {};
+
+template <typename T>
+concept bitset_expression_operand =
+    is_bitset_expression<T> || std::same_as<std::remove_cvref_t<T>, bitset> || is_bitset_view<std::remove_cvref_t<T>>::value;
+
+// Reads an existing bitset or view word by word, realigning unaligned views.
+class bitset_leaf_expression : public bitset_expression<bitset_leaf_expression> {
+public:
+  template <typename View>
+  explicit bitset_leaf_expression(const View& view)
+      : _words(view.get_word_ptr())
+      , _offset(view.get_bit_offset())
+      , _size(view.size()) {}
+
+  std::size_t size() const {
+    return _size;
+  }
+
+  // The words themselves when the view starts on a word boundary, else null.
+  const word_type* aligned_words() const {
+    return _offset == 0 ? _words : nullptr;
+  }
+
+  const bitset_leaf_expression& leaf() const {
+    return *this;
+  }
+
+  word_type word(std::size_t index) const {
+    if (_offset == 0) {
+      return _words[index];
+    }
+    word_type result = _words[index] >> _offset;
+    if ((index + 1) * BITS_PER_WORD < _offset + _size) {
+      result |= _words[index + 1] << (BITS_PER_WORD - _offset);
+    }
+    return result;
+  }
+
+  template <typename Bitset>
+  Bitset* storage() const {
+    return nullptr;
+  }
+
+private:
+  const word_type* _words;
+  std::size_t _offset;
+  std::size_t _size;
+};
+
+// Keeps a temporary bitset alive for the lifetime of the expression. Its
+// buffer can be reused for the result when the expression is materialized.
+template <typename Bitset>
+class bitset_owned_expression : public bitset_expression<bitset_owned_expression<Bitset>> {
+public:
+  using word_type = typename bitset_expression<bitset_owned_expression<Bitset>>::word_type;
+
+  explicit bitset_owned_expression(Bitset&& value)
+      : _value(std::move(value))
+      , _leaf(_value.subview()) {}
+
+  bitset_owned_expression(const bitset_owned_expression& other)
+      : _value(other._value)
+      , _leaf(_value.subview()) {}
+
+  bitset_owned_expression(bitset_owned_expression&& other) noexcept
+      : _value(std::move(other._value))
+      , _leaf(_value.subview()) {}
+
+  bitset_owned_expression& operator=(const bitset_owned_expression& other) = delete;
+
+  std::size_t size() const {
+    return _leaf.size();
+  }
+
+  word_type word(std::size_t index) const {
+    return _leaf.word(index);
+  }
+
+  const bitset_leaf_expression& leaf() const {
+    return _leaf;
+  }
+
+  template <typename>
+  Bitset* storage() {
+    return &_value;
+  }
+
+private:
+  Bitset _value;
+  bitset_leaf_expression _leaf;
+};
+
+// When both operands are word-aligned bitsets or views, count(), any() and
+// evaluate() go straight to the kernel table instead of the generic word loop.
+template <typename Operation, typename Lhs, typename Rhs>
+class bitset_binary_expression : public bitset_expression<bitset_binary_expression<Operation, Lhs, Rhs>> {
+  using base = bitset_expression<bitset_binary_expression<Operation, Lhs, Rhs>>;
+  using kernels = bitset_binary_kernels<Operation>;
+
+public:
+  using word_type = typename base::word_type;
+
+  static constexpr std::size_t BITS_PER_WORD = base::BITS_PER_WORD;
+
+  bitset_binary_expression(Lhs lhs, Rhs rhs)
+      : _lhs(std::move(lhs))
+      , _rhs(std::move(rhs)) {}
+
+  std::size_t size() const {
+    return _lhs.size();
+  }
+
+  word_type word(std::size_t index) const {
+    return Operation()(_lhs.word(index), _rhs.word(index));
+  }
+
+  std::size_t count() const {
+    if constexpr (kernels::COUNT != nullptr) {
+      const word_type* lhs = aligned_words(_lhs);
+      const word_type* rhs = aligned_words(_rhs);
+      if (lhs != nullptr && rhs != nullptr) {
+        std::size_t full_words = size() / BITS_PER_WORD;
+        std::size_t result = (active_kernels().*kernels::COUNT)(lhs, rhs, full_words);
+        if (std::size_t tail = size() % BITS_PER_WORD; tail != 0) {
+          result += std::popcount(Operation()(lhs[full_words], rhs[full_words]) & base::tail_mask(tail));
+        }
+        return result;
+      }
+    }
+    return base::count();
+  }
+
+  bool any() const {
+    if constexpr (kernels::ANY != nullptr) {
+      const word_type* lhs = aligned_words(_lhs);
+      const word_type* rhs = aligned_words(_rhs);
+      if (lhs != nullptr && rhs != nullptr) {
+        std::size_t full_words = size() / BITS_PER_WORD;
+        if ((active_kernels().*kernels::ANY)(lhs, rhs, full_words)) {
+          return true;
+        }
+        std::size_t tail = size() % BITS_PER_WORD;
+        return tail != 0 && (Operation()(lhs[full_words], rhs[full_words]) & base::tail_mask(tail)) != 0;
+      }
+    }
+    return base::any();
+  }
+
+  // The kernels work on whole buffers, so they are only used when `dst` is one
+  // of the operands or does not overlap them; otherwise the word loop keeps the
+  // guarantee that a word is written only after the words it depends on are read.
+  void evaluate(word_type* dst) const {
+    if constexpr (kernels::ASSIGN != nullptr) {
+      const word_type* lhs = aligned_words(_lhs);
+      const word_type* rhs = aligned_words(_rhs);
+      std::size_t words = (size() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+      if (kernels::COMMUTATIVE && dst == rhs) {
+        std::swap(lhs, rhs);
+      }
+      if (lhs != nullptr && rhs != nullptr && (dst == lhs || disjoint(dst, lhs, words)) &&
+          (dst == rhs ? dst == lhs : disjoint(dst, rhs, words))) {
+        if (dst != lhs) {
+          std::copy_n(lhs, words, dst);
+        }
+        (active_kernels().*kernels::ASSIGN)(dst, rhs, words);
+        return;
+      }
+    }
+    base::evaluate(dst);
+  }
+
+  template <typename Bitset>
+  Bitset* storage() {
+    Bitset* result = _lhs.template storage<Bitset>();
+    return result != nullptr ? result : _rhs.template storage<Bitset>();
+  }
+
+private:
+  Lhs _lhs;
+  Rhs _rhs;
+
+  template <typename Operand>
+  static const word_type* aligned_words(const Operand& operand) {
+    if constexpr (requires { operand.leaf(); }) {
+      return operand.leaf().aligned_words();
+    } else {
+      return nullptr;
+    }
+  }
+
+  static bool disjoint(const word_type* lhs, const word_type* rhs, std::size_t count) {
+    return std::less_equal<const word_type*>()(lhs + count, rhs) || std::less_equal<const word_type*>()(rhs + count, lhs);
+  }
+};
+
+template <typename Operand>
+class bitset_not_expression : public bitset_expression<bitset_not_expression<Operand>> {
+public:
+  using word_type = typename bitset_expression<bitset_not_expression<Operand>>::word_type;
+
+  explicit bitset_not_expression(Operand operand)
+      : _operand(std::move(operand)) {}
+
+  std::size_t size() const {
+    return _operand.size();
+  }
+
+  word_type word(std::size_t index) const {
+    return ~_operand.word(index);
+  }
+
+  template <typename Bitset>
+  Bitset* storage() {
+    return _operand.template storage<Bitset>();
+  }
+
+private:
+  Operand _operand;
+};
+
+template <typename T>
+  requires bitset_expression_operand<T>
+auto make_bitset_expression(T&& operand) {
+  using type = std::remove_cvref_t<T>;
+  if constexpr (is_bitset_expression<T>) {
+    return type(std::forward<T>(operand));
+  } else if constexpr (is_bitset_view<type>::value) {
+    return bitset_leaf_expression(operand);
+  } else if constexpr (std::is_lvalue_reference_v<T> || std::is_const_v<std::remove_reference_t<T>>) {
+    return bitset_leaf_expression(operand.subview());
+  } else {
+    return bitset_owned_expression<type>(std::move(operand));
+  }
+}
+
+template <typename Operation, typename Lhs, typename Rhs>
+auto make_bitset_binary_expression(Lhs&& lhs, Rhs&& rhs) {
+  using lhs_type = decltype(make_bitset_expression(std::forward<Lhs>(lhs)));
+  using rhs_type = decltype(make_bitset_expression(std::forward<Rhs>(rhs)));
+  return bitset_binary_expression<Operation, lhs_type, rhs_type>(
+      make_bitset_expression(std::forward<Lhs>(lhs)), make_bitset_expression(std::forward<Rhs>(rhs))
+  );
+}
+
+template <typename Lhs, typename Rhs>
+  requires bitset_expression_operand<Lhs> && bitset_expression_operand<Rhs>
+auto operator&(Lhs&& lhs, Rhs&& rhs) {
+  return make_bitset_binary_expression<std::bit_and<uint64_t>>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
+template <typename Lhs, typename Rhs>
+  requires bitset_expression_operand<Lhs> && bitset_expression_operand<Rhs>
+auto operator|(Lhs&& lhs, Rhs&& rhs) {
+  return make_bitset_binary_expression<std::bit_or<uint64_t>>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
+template <typename Lhs, typename Rhs>
+  requires bitset_expression_operand<Lhs> && bitset_expression_operand<Rhs>
+auto operator^(Lhs&& lhs, Rhs&& rhs) {
+  return make_bitset_binary_expression<std::bit_xor<uint64_t>>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
+// Lazy `lhs & ~rhs`.
+template <typename Lhs, typename Rhs>
+  requires bitset_expression_operand<Lhs> && bitset_expression_operand<Rhs>
+auto andnot(Lhs&& lhs, Rhs&& rhs) {
+  return make_bitset_binary_expression<bit_andnot>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
+template <typename Operand>
+  requires bitset_expression_operand<Operand>
+auto operator~(Operand&& operand) {
+  using operand_type = decltype(make_bitset_expression(std::forward<Operand>(operand)));
+  return bitset_not_expression<operand_type>(make_bitset_expression(std::forward<Operand>(operand)));
+}
@@ -9,6 +9,9 @@
 #include <type_traits>
 #include <utility>
 
+template <typename T>
+struct bitset_algorithms;
+
 template <typename T>
 class bitset_iterator {
   friend class bitset;
@@ -16,6 +19,12 @@ class bitset_iterator {
   friend class bitset_reference;
   template <typename>
   friend class bitset_iterator;
+  template <typename>
+  friend class bitset_view;
+  template <std::size_t, typename>
+  friend class static_bitset;
+  template <typename>
+  friend struct bitset_algorithms;
 
 public:
   using word_type = T;
@@ -152,6 +161,59 @@ public:
     }
   }
 
+  // Word-at-a-time versions of standard algorithms (see bitset-algorithm.h).
+  // They are hidden friends, found by argument-dependent lookup of unqualified
+  // calls such as `using std::copy; copy(first, last, d_first);`, and are
+  // preferred over the generic templates. Qualified std:: calls are not
+  // affected.
+  template <typename U>
+  friend bitset_iterator<U> copy(bitset_iterator first, bitset_iterator last, bitset_iterator<U> d_first) {
+    return bitset_algorithms<T>::copy(first, last, d_first);
+  }
+
+  template <typename U>
+  friend bitset_iterator<U> move(bitset_iterator first, bitset_iterator last, bitset_iterator<U> d_first) {
+    return bitset_algorithms<T>::copy(first, last, d_first);
+  }
+
+  template <typename U>
+  friend bitset_iterator<U> copy_backward(bitset_iterator first, bitset_iterator last, bitset_iterator<U> d_last) {
+    return bitset_algorithms<T>::copy_backward(first, last, d_last);
+  }
+
+  friend void fill(bitset_iterator first, bitset_iterator last, bool value) {
+    bitset_algorithms<T>::fill(first, last, value);
+  }
+
+  template <typename Size>
+  friend bitset_iterator fill_n(bitset_iterator first, Size count, bool value) {
+    bitset_iterator last = first + static_cast<difference_type>(count);
+    bitset_algorithms<T>::fill(first, last, value);
+    return last;
+  }
+
+  template <typename U>
+  friend bool equal(bitset_iterator first_1, bitset_iterator last_1, bitset_iterator<U> first_2) {
+    return bitset_algorithms<T>::equal(first_1, last_1, first_2);
+  }
+
+  friend difference_type count(bitset_iterator first, bitset_iterator last, bool value) {
+    return bitset_algorithms<T>::count(first, last, value);
+  }
+
+  friend bitset_iterator find(bitset_iterator first, bitset_iterator last, bool value) {
+    return bitset_algorithms<T>::find(first, last, value);
+  }
+
+  template <typename U>
+  friend bitset_iterator<U> swap_ranges(bitset_iterator first_1, bitset_iterator last_1, bitset_iterator<U> first_2) {
+    return bitset_algorithms<T>::swap_ranges(first_1, last_1, first_2);
+  }
+
+  friend bitset_iterator rotate(bitset_iterator first, bitset_iterator middle, bitset_iterator last) {
+    return bitset_algorithms<T>::rotate(first, middle, last);
+  }
+
   inline static word_type create_mask(std::size_t n) {
     if (n == BITS_PER_WORD) {
       return static_cast<word_type>(-1);
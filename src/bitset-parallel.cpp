@@ -0,0 +1,252 @@
+#include "bitset-parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t CACHE_LINE_BYTES = 64;
+constexpr std::size_t CACHE_LINE_BITS = CACHE_LINE_BYTES * CHAR_BIT;
+// Short-circuiting reductions check whether another thread has already
+// decided the result after every 4 KiB.
+constexpr std::size_t BLOCK_BITS = 64 * CACHE_LINE_BITS;
+
+} // namespace
+
+// Knows where a view lives in memory, so it can be split at cache lines.
+class bitset_chunks {
+public:
+  // Start of every chunk, followed by the size of `bits`.
+  static std::vector<std::size_t> split(const parallel_policy& policy, const bitset::const_view& bits) {
+    std::size_t size = bits.size();
+    std::size_t threads = policy.threads != 0 ? policy.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::size_t chunks = std::clamp<std::size_t>(size / std::max<std::size_t>(policy.min_chunk_bits, 1), 1, threads);
+
+    std::vector<std::size_t> bounds{0};
+    if (chunks > 1) {
+      auto address = reinterpret_cast<std::uintptr_t>(bits.get_word_ptr());
+      std::size_t first_bit = address % CACHE_LINE_BYTES * CHAR_BIT + bits.get_bit_offset();
+      std::size_t head = (CACHE_LINE_BITS - first_bit % CACHE_LINE_BITS) % CACHE_LINE_BITS;
+      std::size_t chunk_bits = (size / chunks + CACHE_LINE_BITS - 1) / CACHE_LINE_BITS * CACHE_LINE_BITS;
+      for (std::size_t i = 1; i < chunks && head + i * chunk_bits < size; ++i) {
+        bounds.push_back(head + i * chunk_bits);
+      }
+    }
+    bounds.push_back(size);
+    return bounds;
+  }
+};
+
+namespace {
+
+// Threads shared by every parallel call. They are started on first use, as
+// many as the widest call so far has asked for, and kept until exit.
+class worker_pool {
+public:
+  static worker_pool& instance() {
+    static worker_pool pool;
+    return pool;
+  }
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  ~worker_pool() {
+    {
+      std::lock_guard lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::thread& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  // Calls `job(i)` for every i in [0, count) and returns once all calls are
+  // done. The calling thread takes part, so every job still runs if the pool
+  // is busy with other callers or a thread could not be started. `job` must
+  // not throw.
+  void run(std::size_t count, const std::function<void(std::size_t)>& job) {
+    batch work{&job, count};
+    {
+      std::lock_guard lock(_mutex);
+      grow(count - 1);
+      _batches.push_back(&work);
+    }
+    _wake.notify_all();
+
+    std::unique_lock lock(_mutex);
+    while (std::optional<std::size_t> index = claim(work)) {
+      lock.unlock();
+      job(*index);
+      lock.lock();
+      ++work.finished;
+    }
+    _done.wait(lock, [&] { return work.finished == work.count; });
+  }
+
+private:
+  struct batch {
+    const std::function<void(std::size_t)>* job;
+    std::size_t count;
+    std::size_t next = 0;
+    std::size_t finished = 0;
+  };
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  std::deque<batch*> _batches;
+  std::vector<std::thread> _threads;
+  bool _stopping = false;
+
+  worker_pool() = default;
+
+  void grow(std::size_t threads) {
+    while (_threads.size() < threads) {
+      try {
+        _threads.emplace_back([this] { serve(); });
+      } catch (const std::system_error&) {
+        break;
+      }
+    }
+  }
+
+  // Next unclaimed job of `work`; the batch leaves the queue with its last job.
+  std::optional<std::size_t> claim(batch& work) {
+    if (work.next == work.count) {
+      return std::nullopt;
+    }
+    std::size_t index = work.next++;
+    if (work.next == work.count) {
+      _batches.erase(std::find(_batches.begin(), _batches.end(), &work));
+    }
+    return index;
+  }
+
+  void serve() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+      _wake.wait(lock, [this] { return _stopping || !_batches.empty(); });
+      if (_stopping) {
+        return;
+      }
+      batch& current = *_batches.front();
+      std::size_t index = *claim(current);
+      lock.unlock();
+      (*current.job)(index);
+      lock.lock();
+      if (++current.finished == current.count) {
+        _done.notify_all();
+      }
+    }
+  }
+};
+
+// Runs `task(chunk, begin, end)` for every chunk on the worker pool and the
+// calling thread. If any chunk throws, the first exception is rethrown once
+// all chunks have finished.
+template <typename Task>
+void for_each_chunk(const std::vector<std::size_t>& bounds, const Task& task) {
+  std::size_t chunks = bounds.size() - 1;
+  if (chunks == 1) {
+    task(0, bounds[0], bounds[1]);
+    return;
+  }
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  worker_pool::instance().run(chunks, [&](std::size_t chunk) {
+    try {
+      task(chunk, bounds[chunk], bounds[chunk + 1]);
+    } catch (...) {
+      std::lock_guard lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+template <typename Operation>
+void assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src, Operation operation) {
+  for_each_chunk(bitset_chunks::split(policy, dst), [&](std::size_t, std::size_t begin, std::size_t end) {
+    operation(dst.subview(begin, end - begin), src.subview(begin, end - begin));
+  });
+}
+
+// Whether `test(begin, count)` holds for some block; once one thread finds
+// such a block the others stop at their next block boundary.
+template <typename Test>
+bool any_block(const parallel_policy& policy, const bitset::const_view& bits, Test test) {
+  std::atomic<bool> found = false;
+  for_each_chunk(bitset_chunks::split(policy, bits), [&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t pos = begin; pos < end && !found.load(std::memory_order_relaxed); pos += BLOCK_BITS) {
+      if (test(pos, std::min(BLOCK_BITS, end - pos))) {
+        found.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+  return found.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+void parallel_and_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src) {
+  assign(policy, dst, src, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs &= rhs; });
+}
+
+void parallel_or_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src) {
+  assign(policy, dst, src, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs |= rhs; });
+}
+
+void parallel_xor_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src) {
+  assign(policy, dst, src, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs ^= rhs; });
+}
+
+void parallel_flip(const parallel_policy& policy, const bitset::view& bits) {
+  for_each_chunk(bitset_chunks::split(policy, bits), [&](std::size_t, std::size_t begin, std::size_t end) {
+    bits.subview(begin, end - begin).flip();
+  });
+}
+
+std::size_t parallel_count(const parallel_policy& policy, const bitset::const_view& bits) {
+  std::vector<std::size_t> bounds = bitset_chunks::split(policy, bits);
+  std::vector<std::size_t> counts(bounds.size() - 1);
+  for_each_chunk(bounds, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+    counts[chunk] = bits.subview(begin, end - begin).count();
+  });
+  return std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+}
+
+bool parallel_equal(const parallel_policy& policy, const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.size() == rhs.size() && !any_block(policy, lhs, [&](std::size_t begin, std::size_t count) {
+    return lhs.subview(begin, count) != rhs.subview(begin, count);
+  });
+}
+
+bool parallel_any(const parallel_policy& policy, const bitset::const_view& bits) {
+  return any_block(policy, bits, [&](std::size_t begin, std::size_t count) {
+    return bits.subview(begin, count).any();
+  });
+}
+
+bool parallel_all(const parallel_policy& policy, const bitset::const_view& bits) {
+  return !any_block(policy, bits, [&](std::size_t begin, std::size_t count) {
+    return !bits.subview(begin, count).all();
+  });
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+
+// Configures the multi-threaded functions below. The range is split into one
+// chunk per thread; every chunk boundary falls on a cache line of the first
+// argument, so no two threads ever write to the same line. Chunks run on a pool
+// of threads that is started on first use and shared by all calls, with the
+// calling thread taking a chunk too. If a chunk throws, the exception is
+// rethrown after the other chunks have finished.
+struct parallel_policy {
+  // Zero means std::thread::hardware_concurrency().
+  std::size_t threads = 0;
+  // Ranges shorter than this per thread are not worth a thread of their own.
+  std::size_t min_chunk_bits = std::size_t(1) << 20;
+};
+
+inline constexpr parallel_policy parallel{};
+
+// `dst op= src`. Both views must have the same size.
+void parallel_and_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src);
+void parallel_or_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src);
+void parallel_xor_assign(const parallel_policy& policy, const bitset::view& dst, const bitset::const_view& src);
+void parallel_flip(const parallel_policy& policy, const bitset::view& bits);
+
+std::size_t parallel_count(const parallel_policy& policy, const bitset::const_view& bits);
+bool parallel_equal(const parallel_policy& policy, const bitset::const_view& lhs, const bitset::const_view& rhs);
+bool parallel_any(const parallel_policy& policy, const bitset::const_view& bits);
+bool parallel_all(const parallel_policy& policy, const bitset::const_view& bits);
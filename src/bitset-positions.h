@@ -0,0 +1,121 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+// Forward range over the indices of bits equal to `Value`. Each word is loaded
+// once and its matching bits are consumed by clearing the lowest one.
+template <typename T, bool Value>
+class bitset_positions : public std::ranges::view_interface<bitset_positions<T, Value>> {
+  template <typename>
+  friend class bitset_view;
+
+public:
+  using word_type = std::remove_const_t<T>;
+
+  static constexpr std::size_t BITS_PER_WORD = std::numeric_limits<word_type>::digits;
+
+  class iterator {
+    friend class bitset_positions;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::size_t;
+    using pointer = void;
+
+    iterator() = default;
+
+    std::size_t operator*() const {
+      return _word * BITS_PER_WORD + std::countr_zero(_bits) - _first;
+    }
+
+    iterator& operator++() {
+      _bits &= _bits - 1;
+      skip_empty_words();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) {
+      return lhs._word == rhs._word && lhs._bits == rhs._bits;
+    }
+
+  private:
+    const word_type* _words = nullptr;
+    std::size_t _first = 0;
+    std::size_t _last = 0;
+    std::size_t _word = 0;
+    word_type _bits = 0;
+
+    iterator(const word_type* words, std::size_t first, std::size_t last, std::size_t word)
+        : _words(words)
+        , _first(first)
+        , _last(last)
+        , _word(word) {
+      if (_word < end_word()) {
+        _bits = load(_word);
+        skip_empty_words();
+      }
+    }
+
+    std::size_t end_word() const {
+      return (_last + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    }
+
+    word_type load(std::size_t word) const {
+      word_type bits = Value ? _words[word] : static_cast<word_type>(~_words[word]);
+      std::size_t word_begin = word * BITS_PER_WORD;
+      if (_first > word_begin) {
+        bits &= static_cast<word_type>(~word_type{0}) << (_first - word_begin);
+      }
+      if (_last < word_begin + BITS_PER_WORD) {
+        bits &= (word_type{1} << (_last - word_begin)) - 1;
+      }
+      return bits;
+    }
+
+    void skip_empty_words() {
+      while (_bits == 0 && ++_word < end_word()) {
+        _bits = load(_word);
+      }
+      if (_bits == 0) {
+        _word = end_word();
+      }
+    }
+  };
+
+  bitset_positions() = default;
+
+  iterator begin() const {
+    return {_words, _first, _last, _first / BITS_PER_WORD};
+  }
+
+  iterator end() const {
+    return {_words, _first, _last, (_last + BITS_PER_WORD - 1) / BITS_PER_WORD};
+  }
+
+private:
+  const word_type* _words = nullptr;
+  std::size_t _first = 0;
+  std::size_t _last = 0;
+
+  bitset_positions(const word_type* words, std::size_t first, std::size_t last)
+      : _words(words)
+      , _first(first)
+      , _last(last) {}
+};
+
+template <typename T, bool Value>
+inline constexpr bool std::ranges::enable_borrowed_range<bitset_positions<T, Value>> = true;
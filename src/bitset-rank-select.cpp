@@ -0,0 +1,115 @@
+#include "bitset-rank-select.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+std::size_t select_in_word(uint64_t word, std::size_t rank) {
+  for (unsigned shift = 0;; shift += 8) {
+    auto byte = static_cast<unsigned>((word >> shift) & 0xff);
+    auto ones = static_cast<std::size_t>(std::popcount(byte));
+    if (rank < ones) {
+      for (; rank > 0; --rank) {
+        byte &= byte - 1;
+      }
+      return shift + std::countr_zero(byte);
+    }
+    rank -= ones;
+  }
+}
+
+} // namespace
+
+bitset_rank_select::bitset_rank_select(const bitset::const_view& bits)
+    : _bits(bits) {
+  std::size_t num_words = (size() + bitset::BITS_PER_WORD - 1) / bitset::BITS_PER_WORD;
+  std::size_t num_blocks = (num_words + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+  _blocks.reserve(2 * num_blocks);
+  for (std::size_t block = 0; block < num_blocks; ++block) {
+    uint64_t packed = 0;
+    std::size_t in_block = 0;
+    for (std::size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+      std::size_t index = block * WORDS_PER_BLOCK + i;
+      if (i != 0) {
+        packed |= static_cast<uint64_t>(in_block) << (9 * (i - 1));
+      }
+      if (index < num_words) {
+        in_block += std::popcount(word(index));
+      }
+    }
+    std::size_t next_sample = _select_samples.size() * ONES_PER_SAMPLE;
+    while (next_sample < _count + in_block) {
+      _select_samples.push_back(block);
+      next_sample += ONES_PER_SAMPLE;
+    }
+    _blocks.push_back(_count);
+    _blocks.push_back(packed);
+    _count += in_block;
+  }
+}
+
+std::size_t bitset_rank_select::size() const {
+  return _bits.size();
+}
+
+std::size_t bitset_rank_select::count() const {
+  return _count;
+}
+
+bitset::word_type bitset_rank_select::word(std::size_t index) const {
+  std::size_t first = index * bitset::BITS_PER_WORD;
+  std::size_t num_bits = std::min(bitset::BITS_PER_WORD, size() - first);
+  return (_bits.begin() + static_cast<std::ptrdiff_t>(first)).get_n_bits(num_bits);
+}
+
+std::size_t bitset_rank_select::block_rank(std::size_t block) const {
+  return _blocks[2 * block];
+}
+
+std::size_t bitset_rank_select::rank_in_block(std::size_t block, std::size_t word_in_block) const {
+  if (word_in_block == 0) {
+    return 0;
+  }
+  return (_blocks[2 * block + 1] >> (9 * (word_in_block - 1))) & 0x1ff;
+}
+
+std::size_t bitset_rank_select::rank1(std::size_t pos) const {
+  if (pos >= size()) {
+    return _count;
+  }
+  std::size_t index = pos / bitset::BITS_PER_WORD;
+  std::size_t block = index / WORDS_PER_BLOCK;
+  bitset::word_type mask = bitset::iterator::create_mask(pos % bitset::BITS_PER_WORD);
+  return block_rank(block) + rank_in_block(block, index % WORDS_PER_BLOCK) + std::popcount(word(index) & mask);
+}
+
+std::size_t bitset_rank_select::rank0(std::size_t pos) const {
+  return std::min(pos, size()) - rank1(pos);
+}
+
+std::size_t bitset_rank_select::select1(std::size_t rank) const {
+  if (rank >= _count) {
+    return npos;
+  }
+  std::size_t sample = rank / ONES_PER_SAMPLE;
+  std::size_t low = _select_samples[sample];
+  std::size_t high = (sample + 1 < _select_samples.size()) ? _select_samples[sample + 1] + 1 : _blocks.size() / 2;
+  while (high - low > 1) {
+    std::size_t middle = low + (high - low) / 2;
+    if (block_rank(middle) <= rank) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  std::size_t block = low;
+  rank -= block_rank(block);
+  std::size_t word_in_block = 0;
+  while (word_in_block + 1 < WORDS_PER_BLOCK && rank_in_block(block, word_in_block + 1) <= rank) {
+    ++word_in_block;
+  }
+  rank -= rank_in_block(block, word_in_block);
+  std::size_t index = block * WORDS_PER_BLOCK + word_in_block;
+  return index * bitset::BITS_PER_WORD + select_in_word(word(index), rank);
+}
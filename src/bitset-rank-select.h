@@ -0,0 +1,44 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Succinct rank/select index over a read-only view, using the rank9 layout: for
+// every 512-bit block the number of ones before it plus seven packed 9-bit
+// counts of the ones before each of its words. The index refers to the view's
+// storage and must be rebuilt after the bits change.
+class bitset_rank_select {
+public:
+  static constexpr std::size_t npos = bitset::npos;
+
+  explicit bitset_rank_select(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  std::size_t count() const;
+
+  // Number of ones (zeros) in [0, pos).
+  std::size_t rank1(std::size_t pos) const;
+  std::size_t rank0(std::size_t pos) const;
+
+  // Position of the one with the given zero-based rank, or npos.
+  std::size_t select1(std::size_t rank) const;
+
+private:
+  static constexpr std::size_t WORDS_PER_BLOCK = 8;
+  static constexpr std::size_t BITS_PER_BLOCK = WORDS_PER_BLOCK * bitset::BITS_PER_WORD;
+  static constexpr std::size_t ONES_PER_SAMPLE = 4096;
+
+  bitset::const_view _bits;
+  std::size_t _count = 0;
+  // Pairs of (ones before the block, packed per-word counts inside the block).
+  std::vector<uint64_t> _blocks;
+  // Block holding the one of rank `i * ONES_PER_SAMPLE`.
+  std::vector<std::size_t> _select_samples;
+
+  bitset::word_type word(std::size_t index) const;
+  std::size_t block_rank(std::size_t block) const;
+  std::size_t rank_in_block(std::size_t block, std::size_t word_in_block) const;
+};
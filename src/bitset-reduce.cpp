@@ -0,0 +1,126 @@
+#include "bitset-reduce.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace {
+
+// 4 KiB of destination per block.
+constexpr std::size_t BLOCK_BITS = 512 * bitset::BITS_PER_WORD;
+// Words per block of the threshold counters; with up to eight counter planes
+// the whole block stays within 16 KiB.
+constexpr std::size_t COUNTER_BLOCK_WORDS = 256;
+
+// `combine` folds one input into the block and returns false once no later
+// input can change it.
+template <typename Combine>
+bitset reduce(std::span<const bitset::const_view> inputs, Combine combine) {
+  if (inputs.empty()) {
+    return bitset();
+  }
+  std::size_t size = inputs.front().size();
+  bitset result(size, false);
+  for (std::size_t begin = 0; begin < size; begin += BLOCK_BITS) {
+    bitset::view block = result.subview(begin, BLOCK_BITS);
+    block.assign(inputs.front().subview(begin, block.size()));
+    bool active = true;
+    for (std::size_t i = 1; i < inputs.size() && active; ++i) {
+      active = combine(block, inputs[i].subview(begin, block.size()));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+// The AND pass ORs together the words it writes, so an emptied block is
+// noticed without scanning it again before the next input.
+bitset reduce_and(std::span<const bitset::const_view> inputs) {
+  return reduce(inputs, [](const bitset::view& block, const bitset::const_view& input) {
+    uint64_t written = 0;
+    auto and_word = [&written](uint64_t lhs, uint64_t rhs, uint64_t) {
+      uint64_t word = lhs & rhs;
+      written |= word;
+      return word;
+    };
+    block.apply(and_word, block, input, input);
+    return written != 0;
+  });
+}
+
+bitset reduce_or(std::span<const bitset::const_view> inputs) {
+  return reduce(inputs, [](const bitset::view& block, const bitset::const_view& input) {
+    block |= input;
+    return true;
+  });
+}
+
+bitset reduce_xor(std::span<const bitset::const_view> inputs) {
+  return reduce(inputs, [](const bitset::view& block, const bitset::const_view& input) {
+    block ^= input;
+    return true;
+  });
+}
+
+// Every input is added into bit-sliced counters: plane p holds bit p of the
+// per-position count. The counters are then compared with `threshold` one
+// plane at a time, from the most significant down.
+bitset reduce_at_least(std::span<const bitset::const_view> inputs, std::size_t threshold) {
+  std::size_t size = inputs.empty() ? 0 : inputs.front().size();
+  if (threshold == 0) {
+    return bitset(size, true);
+  }
+  if (threshold > inputs.size()) {
+    return bitset(size, false);
+  }
+  if (threshold == 1) {
+    return reduce_or(inputs);
+  }
+  if (threshold == inputs.size()) {
+    return reduce_and(inputs);
+  }
+
+  std::vector<bitset_leaf_expression> leaves;
+  leaves.reserve(inputs.size());
+  for (const bitset::const_view& input : inputs) {
+    leaves.emplace_back(input);
+  }
+
+  std::size_t planes = std::bit_width(inputs.size());
+  std::vector<uint64_t> counters(planes * COUNTER_BLOCK_WORDS);
+  bitset result(size, false);
+  std::size_t total_words = (size + bitset::BITS_PER_WORD - 1) / bitset::BITS_PER_WORD;
+  for (std::size_t first = 0; first < total_words; first += COUNTER_BLOCK_WORDS) {
+    std::size_t words = std::min(COUNTER_BLOCK_WORDS, total_words - first);
+    std::fill(counters.begin(), counters.end(), 0);
+    for (const bitset_leaf_expression& leaf : leaves) {
+      for (std::size_t i = 0; i < words; ++i) {
+        uint64_t carry = leaf.word(first + i);
+        for (std::size_t plane = 0; plane < planes && carry != 0; ++plane) {
+          uint64_t& counter = counters[plane * COUNTER_BLOCK_WORDS + i];
+          uint64_t next = counter & carry;
+          counter ^= carry;
+          carry = next;
+        }
+      }
+    }
+    for (std::size_t i = 0; i < words; ++i) {
+      uint64_t greater = 0;
+      uint64_t equal = ~uint64_t(0);
+      for (std::size_t plane = planes; plane-- > 0;) {
+        uint64_t counter = counters[plane * COUNTER_BLOCK_WORDS + i];
+        if ((threshold >> plane) & 1) {
+          equal &= counter;
+        } else {
+          greater |= equal & counter;
+          equal &= ~counter;
+        }
+      }
+      std::size_t pos = (first + i) * bitset::BITS_PER_WORD;
+      std::size_t bits = std::min(bitset::BITS_PER_WORD, size - pos);
+      (result.begin() + static_cast<bitset::difference_type>(pos)).change_n_bits(greater | equal, bits);
+    }
+  }
+  return result;
+}
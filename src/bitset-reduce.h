@@ -0,0 +1,18 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <span>
+
+// Combine any number of views in one pass. The result is built one block at a
+// time and every input is folded into the block while it is still in L1, instead
+// of streaming the whole destination once per input. The result has the size of
+// the first input; the others must be at least as long. An empty span gives an
+// empty bitset.
+bitset reduce_and(std::span<const bitset::const_view> inputs);
+bitset reduce_or(std::span<const bitset::const_view> inputs);
+bitset reduce_xor(std::span<const bitset::const_view> inputs);
+
+// Bits set in at least `threshold` of the inputs.
+bitset reduce_at_least(std::span<const bitset::const_view> inputs, std::size_t threshold);
@@ -0,0 +1,833 @@
+#include "bitset-simd.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <numeric>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BITSET_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct word_and {
+  static uint64_t word(uint64_t lhs, uint64_t rhs) {
+    return lhs & rhs;
+  }
+};
+
+struct word_or {
+  static uint64_t word(uint64_t lhs, uint64_t rhs) {
+    return lhs | rhs;
+  }
+};
+
+struct word_xor {
+  static uint64_t word(uint64_t lhs, uint64_t rhs) {
+    return lhs ^ rhs;
+  }
+};
+
+struct word_andnot {
+  static uint64_t word(uint64_t lhs, uint64_t rhs) {
+    return lhs & ~rhs;
+  }
+};
+
+template <typename Op>
+void scalar_binary(uint64_t* dst, const uint64_t* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = Op::word(dst[i], src[i]);
+  }
+}
+
+void scalar_not(uint64_t* words, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    words[i] = ~words[i];
+  }
+}
+
+std::size_t scalar_popcount(const uint64_t* words, std::size_t count) {
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    result += std::popcount(words[i]);
+  }
+  return result;
+}
+
+template <typename Op>
+std::size_t scalar_binary_popcount(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    result += std::popcount(Op::word(lhs[i], rhs[i]));
+  }
+  return result;
+}
+
+template <typename Op>
+bool scalar_binary_any(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (Op::word(lhs[i], rhs[i]) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool scalar_equal(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  return std::equal(lhs, lhs + count, rhs);
+}
+
+bool scalar_all(const uint64_t* words, std::size_t count) {
+  return std::all_of(words, words + count, [](uint64_t word) { return ~word == 0; });
+}
+
+bool scalar_any(const uint64_t* words, std::size_t count) {
+  return std::any_of(words, words + count, [](uint64_t word) { return word != 0; });
+}
+
+template <typename Index>
+std::size_t scalar_decode(const uint64_t* words, std::size_t count, Index base, Index* out) {
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; ++i, base += 64) {
+    for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+      out[written++] = base + static_cast<Index>(std::countr_zero(word));
+    }
+  }
+  return written;
+}
+
+template <uint8_t Function>
+struct scalar_ternary {
+  static void run(uint64_t* dst, const uint64_t* a, const uint64_t* b, const uint64_t* c, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] = ternary_word<Function>(a[i], b[i], c[i]);
+    }
+  }
+};
+
+template <template <uint8_t> typename Kernel, std::size_t... Functions>
+constexpr std::array<ternary_kernel, 256> make_ternary_table(std::index_sequence<Functions...>) {
+  return {Kernel<static_cast<uint8_t>(Functions)>::run...};
+}
+
+constexpr std::array<ternary_kernel, 256> scalar_ternary_table =
+    make_ternary_table<scalar_ternary>(std::make_index_sequence<256>());
+
+constexpr bitset_kernels scalar_kernels = {
+    scalar_binary<word_and>,
+    scalar_binary<word_or>,
+    scalar_binary<word_xor>,
+    scalar_binary<word_andnot>,
+    scalar_not,
+    scalar_popcount,
+    scalar_binary_popcount<word_and>,
+    scalar_binary_popcount<word_or>,
+    scalar_binary_popcount<word_xor>,
+    scalar_binary_popcount<word_andnot>,
+    scalar_binary_any<word_and>,
+    scalar_binary_any<word_andnot>,
+    scalar_equal,
+    scalar_all,
+    scalar_any,
+    scalar_decode<uint32_t>,
+    scalar_decode<uint64_t>,
+    scalar_ternary_table.data(),
+};
+
+#ifdef BITSET_SIMD_X86
+
+#define BITSET_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define BITSET_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+#define BITSET_TARGET_AVX512_POPCNT __attribute__((target("avx512f,avx512bw,avx512vpopcntdq,popcnt")))
+
+struct avx2_and : word_and {
+  BITSET_TARGET_AVX2 static __m256i vector(__m256i lhs, __m256i rhs) {
+    return _mm256_and_si256(lhs, rhs);
+  }
+};
+
+struct avx2_or : word_or {
+  BITSET_TARGET_AVX2 static __m256i vector(__m256i lhs, __m256i rhs) {
+    return _mm256_or_si256(lhs, rhs);
+  }
+};
+
+struct avx2_xor : word_xor {
+  BITSET_TARGET_AVX2 static __m256i vector(__m256i lhs, __m256i rhs) {
+    return _mm256_xor_si256(lhs, rhs);
+  }
+};
+
+struct avx2_andnot : word_andnot {
+  BITSET_TARGET_AVX2 static __m256i vector(__m256i lhs, __m256i rhs) {
+    return _mm256_andnot_si256(rhs, lhs);
+  }
+};
+
+BITSET_TARGET_AVX2 __m256i avx2_load(const uint64_t* words) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+}
+
+BITSET_TARGET_AVX2 void avx2_store(uint64_t* words, __m256i value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), value);
+}
+
+template <typename Op>
+BITSET_TARGET_AVX2 void avx2_binary(uint64_t* dst, const uint64_t* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    avx2_store(dst + i, Op::vector(avx2_load(dst + i), avx2_load(src + i)));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Op::word(dst[i], src[i]);
+  }
+}
+
+BITSET_TARGET_AVX2 void avx2_not(uint64_t* words, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    avx2_store(words + i, _mm256_xor_si256(avx2_load(words + i), ones));
+  }
+  for (; i < count; ++i) {
+    words[i] = ~words[i];
+  }
+}
+
+BITSET_TARGET_AVX2 __m256i avx2_popcount_bytes(__m256i value) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i low = _mm256_and_si256(value, low_mask);
+  __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask);
+  __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+  return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// Carry-save adder: adds three bit-sliced inputs into `high` and `low` planes.
+BITSET_TARGET_AVX2 void avx2_csa(__m256i& high, __m256i& low, __m256i a, __m256i b, __m256i c) {
+  __m256i u = _mm256_xor_si256(a, b);
+  high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+  low = _mm256_xor_si256(u, c);
+}
+
+// Words fed to the Harley-Seal popcount: either stored words or the result
+// of a binary operation computed on the fly.
+struct avx2_words {
+  const uint64_t* words;
+
+  BITSET_TARGET_AVX2 __m256i vector(std::size_t index) const {
+    return avx2_load(words + index);
+  }
+
+  uint64_t word(std::size_t index) const {
+    return words[index];
+  }
+};
+
+template <typename Op>
+struct avx2_combined_words {
+  const uint64_t* lhs;
+  const uint64_t* rhs;
+
+  BITSET_TARGET_AVX2 __m256i vector(std::size_t index) const {
+    return Op::vector(avx2_load(lhs + index), avx2_load(rhs + index));
+  }
+
+  uint64_t word(std::size_t index) const {
+    return Op::word(lhs[index], rhs[index]);
+  }
+};
+
+// Harley-Seal population count: sixteen vectors are reduced through a tree of
+// carry-save adders, so the byte-lookup popcount runs once per 1024 bits.
+template <typename Source>
+BITSET_TARGET_AVX2 std::size_t avx2_harley_seal(const Source& source, std::size_t count) {
+  __m256i total = _mm256_setzero_si256();
+  __m256i ones = _mm256_setzero_si256();
+  __m256i twos = _mm256_setzero_si256();
+  __m256i fours = _mm256_setzero_si256();
+  __m256i eights = _mm256_setzero_si256();
+  __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b, sixteens;
+  std::size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    avx2_csa(twos_a, ones, ones, source.vector(i), source.vector(i + 4));
+    avx2_csa(twos_b, ones, ones, source.vector(i + 8), source.vector(i + 12));
+    avx2_csa(fours_a, twos, twos, twos_a, twos_b);
+    avx2_csa(twos_a, ones, ones, source.vector(i + 16), source.vector(i + 20));
+    avx2_csa(twos_b, ones, ones, source.vector(i + 24), source.vector(i + 28));
+    avx2_csa(fours_b, twos, twos, twos_a, twos_b);
+    avx2_csa(eights_a, fours, fours, fours_a, fours_b);
+    avx2_csa(twos_a, ones, ones, source.vector(i + 32), source.vector(i + 36));
+    avx2_csa(twos_b, ones, ones, source.vector(i + 40), source.vector(i + 44));
+    avx2_csa(fours_a, twos, twos, twos_a, twos_b);
+    avx2_csa(twos_a, ones, ones, source.vector(i + 48), source.vector(i + 52));
+    avx2_csa(twos_b, ones, ones, source.vector(i + 56), source.vector(i + 60));
+    avx2_csa(fours_b, twos, twos, twos_a, twos_b);
+    avx2_csa(eights_b, fours, fours, fours_a, fours_b);
+    avx2_csa(sixteens, eights, eights, eights_a, eights_b);
+    total = _mm256_add_epi64(total, avx2_popcount_bytes(sixteens));
+  }
+  total = _mm256_slli_epi64(total, 4);
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(avx2_popcount_bytes(eights), 3));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(avx2_popcount_bytes(fours), 2));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(avx2_popcount_bytes(twos), 1));
+  total = _mm256_add_epi64(total, avx2_popcount_bytes(ones));
+  for (; i + 4 <= count; i += 4) {
+    total = _mm256_add_epi64(total, avx2_popcount_bytes(source.vector(i)));
+  }
+  std::size_t result = static_cast<std::size_t>(
+      _mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) + _mm256_extract_epi64(total, 2) +
+      _mm256_extract_epi64(total, 3)
+  );
+  for (; i < count; ++i) {
+    result += _mm_popcnt_u64(source.word(i));
+  }
+  return result;
+}
+
+BITSET_TARGET_AVX2 std::size_t avx2_popcount(const uint64_t* words, std::size_t count) {
+  return avx2_harley_seal(avx2_words{words}, count);
+}
+
+template <typename Op>
+BITSET_TARGET_AVX2 std::size_t avx2_binary_popcount(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  return avx2_harley_seal(avx2_combined_words<Op>{lhs, rhs}, count);
+}
+
+BITSET_TARGET_AVX2 bool avx2_and_any(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    if (!_mm256_testz_si256(avx2_load(lhs + i), avx2_load(rhs + i))) {
+      return true;
+    }
+  }
+  return scalar_binary_any<word_and>(lhs + i, rhs + i, count - i);
+}
+
+BITSET_TARGET_AVX2 bool avx2_andnot_any(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    // testc is set when every bit of lhs is also set in rhs.
+    if (!_mm256_testc_si256(avx2_load(rhs + i), avx2_load(lhs + i))) {
+      return true;
+    }
+  }
+  return scalar_binary_any<word_andnot>(lhs + i, rhs + i, count - i);
+}
+
+BITSET_TARGET_AVX2 bool avx2_equal(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i diff = _mm256_xor_si256(avx2_load(lhs + i), avx2_load(rhs + i));
+    if (!_mm256_testz_si256(diff, diff)) {
+      return false;
+    }
+  }
+  return std::equal(lhs + i, lhs + count, rhs + i);
+}
+
+BITSET_TARGET_AVX2 bool avx2_all(const uint64_t* words, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    if (!_mm256_testc_si256(avx2_load(words + i), ones)) {
+      return false;
+    }
+  }
+  return scalar_all(words + i, count - i);
+}
+
+BITSET_TARGET_AVX2 bool avx2_any(const uint64_t* words, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i value = avx2_load(words + i);
+    if (!_mm256_testz_si256(value, value)) {
+      return true;
+    }
+  }
+  return scalar_any(words + i, count - i);
+}
+
+struct byte_decode_table {
+  uint8_t entries[256][8];
+};
+
+// Bit positions of every byte value, padded with zeros to eight entries.
+constexpr byte_decode_table make_byte_decode_table() {
+  byte_decode_table table{};
+  for (unsigned value = 0; value < 256; ++value) {
+    unsigned written = 0;
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      if ((value >> bit) & 1) {
+        table.entries[value][written++] = static_cast<uint8_t>(bit);
+      }
+    }
+  }
+  return table;
+}
+
+alignas(64) constexpr byte_decode_table decode_table = make_byte_decode_table();
+
+// Words with only a few set bits are cheaper to decode one bit at a time.
+constexpr int SPARSE_DECODE_LIMIT = 4;
+
+BITSET_TARGET_AVX2 __m256i avx2_byte_positions(unsigned byte) {
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(decode_table.entries[byte])));
+}
+
+BITSET_TARGET_AVX2 std::size_t avx2_decode_u32(const uint64_t* words, std::size_t count, uint32_t base, uint32_t* out) {
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; ++i, base += 64) {
+    uint64_t word = words[i];
+    if (std::popcount(word) <= SPARSE_DECODE_LIMIT) {
+      written += scalar_decode(&word, 1, base, out + written);
+      continue;
+    }
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+      auto byte = static_cast<unsigned>((word >> shift) & 0xff);
+      int bits = std::popcount(byte);
+      __m256i positions = _mm256_add_epi32(avx2_byte_positions(byte), _mm256_set1_epi32(static_cast<int>(base + shift)));
+      __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(bits), lanes);
+      _mm256_maskstore_epi32(reinterpret_cast<int*>(out + written), mask, positions);
+      written += bits;
+    }
+  }
+  return written;
+}
+
+BITSET_TARGET_AVX2 std::size_t avx2_decode_u64(const uint64_t* words, std::size_t count, uint64_t base, uint64_t* out) {
+  const __m256i low_lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+  const __m256i high_lanes = _mm256_setr_epi64x(4, 5, 6, 7);
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; ++i, base += 64) {
+    uint64_t word = words[i];
+    if (std::popcount(word) <= SPARSE_DECODE_LIMIT) {
+      written += scalar_decode(&word, 1, base, out + written);
+      continue;
+    }
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+      auto byte = static_cast<unsigned>((word >> shift) & 0xff);
+      int bits = std::popcount(byte);
+      __m256i positions = avx2_byte_positions(byte);
+      __m256i offset = _mm256_set1_epi64x(static_cast<long long>(base + shift));
+      __m256i low = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(positions)), offset);
+      __m256i high = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(positions, 1)), offset);
+      __m256i count_vector = _mm256_set1_epi64x(bits);
+      auto* target = reinterpret_cast<long long*>(out + written);
+      _mm256_maskstore_epi64(target, _mm256_cmpgt_epi64(count_vector, low_lanes), low);
+      _mm256_maskstore_epi64(target + 4, _mm256_cmpgt_epi64(count_vector, high_lanes), high);
+      written += bits;
+    }
+  }
+  return written;
+}
+
+template <uint8_t Function, std::size_t Minterm>
+BITSET_TARGET_AVX2 __m256i avx2_ternary_minterm(__m256i a, __m256i b, __m256i c) {
+  if constexpr (((Function >> Minterm) & 1) == 0) {
+    return _mm256_setzero_si256();
+  } else {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    __m256i x = (Minterm & 4) ? a : _mm256_xor_si256(a, ones);
+    __m256i y = (Minterm & 2) ? b : _mm256_xor_si256(b, ones);
+    __m256i z = (Minterm & 1) ? c : _mm256_xor_si256(c, ones);
+    return _mm256_and_si256(_mm256_and_si256(x, y), z);
+  }
+}
+
+// Sum of the minterms selected by the truth table; terms that are not part of
+// the function fold away at compile time.
+template <uint8_t Function, std::size_t... Minterms>
+BITSET_TARGET_AVX2 __m256i avx2_ternary_vector(__m256i a, __m256i b, __m256i c, std::index_sequence<Minterms...>) {
+  __m256i result = _mm256_setzero_si256();
+  ((result = _mm256_or_si256(result, avx2_ternary_minterm<Function, Minterms>(a, b, c))), ...);
+  return result;
+}
+
+template <uint8_t Function>
+struct avx2_ternary {
+  BITSET_TARGET_AVX2 static void run(
+      uint64_t* dst,
+      const uint64_t* a,
+      const uint64_t* b,
+      const uint64_t* c,
+      std::size_t count
+  ) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m256i result =
+          avx2_ternary_vector<Function>(avx2_load(a + i), avx2_load(b + i), avx2_load(c + i), std::make_index_sequence<8>());
+      avx2_store(dst + i, result);
+    }
+    for (; i < count; ++i) {
+      dst[i] = ternary_word<Function>(a[i], b[i], c[i]);
+    }
+  }
+};
+
+constexpr std::array<ternary_kernel, 256> avx2_ternary_table =
+    make_ternary_table<avx2_ternary>(std::make_index_sequence<256>());
+
+constexpr bitset_kernels avx2_kernels = {
+    avx2_binary<avx2_and>,
+    avx2_binary<avx2_or>,
+    avx2_binary<avx2_xor>,
+    avx2_binary<avx2_andnot>,
+    avx2_not,
+    avx2_popcount,
+    avx2_binary_popcount<avx2_and>,
+    avx2_binary_popcount<avx2_or>,
+    avx2_binary_popcount<avx2_xor>,
+    avx2_binary_popcount<avx2_andnot>,
+    avx2_and_any,
+    avx2_andnot_any,
+    avx2_equal,
+    avx2_all,
+    avx2_any,
+    avx2_decode_u32,
+    avx2_decode_u64,
+    avx2_ternary_table.data(),
+};
+
+struct avx512_and : word_and {
+  BITSET_TARGET_AVX512 static __m512i vector(__m512i lhs, __m512i rhs) {
+    return _mm512_and_si512(lhs, rhs);
+  }
+};
+
+struct avx512_or : word_or {
+  BITSET_TARGET_AVX512 static __m512i vector(__m512i lhs, __m512i rhs) {
+    return _mm512_or_si512(lhs, rhs);
+  }
+};
+
+struct avx512_xor : word_xor {
+  BITSET_TARGET_AVX512 static __m512i vector(__m512i lhs, __m512i rhs) {
+    return _mm512_xor_si512(lhs, rhs);
+  }
+};
+
+struct avx512_andnot : word_andnot {
+  BITSET_TARGET_AVX512 static __m512i vector(__m512i lhs, __m512i rhs) {
+    return _mm512_ternarylogic_epi64(lhs, rhs, rhs, static_cast<uint8_t>(TERNARY_A & ~TERNARY_B));
+  }
+};
+
+BITSET_TARGET_AVX512 __m512i avx512_load(const uint64_t* words) {
+  return _mm512_loadu_si512(words);
+}
+
+BITSET_TARGET_AVX512 void avx512_store(uint64_t* words, __m512i value) {
+  _mm512_storeu_si512(words, value);
+}
+
+template <typename Op>
+BITSET_TARGET_AVX512 void avx512_binary(uint64_t* dst, const uint64_t* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    avx512_store(dst + i, Op::vector(avx512_load(dst + i), avx512_load(src + i)));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Op::word(dst[i], src[i]);
+  }
+}
+
+BITSET_TARGET_AVX512 void avx512_not(uint64_t* words, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    avx512_store(words + i, _mm512_xor_si512(avx512_load(words + i), ones));
+  }
+  for (; i < count; ++i) {
+    words[i] = ~words[i];
+  }
+}
+
+BITSET_TARGET_AVX512 bool avx512_equal(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    if (_mm512_cmpneq_epi64_mask(avx512_load(lhs + i), avx512_load(rhs + i)) != 0) {
+      return false;
+    }
+  }
+  return std::equal(lhs + i, lhs + count, rhs + i);
+}
+
+BITSET_TARGET_AVX512 bool avx512_all(const uint64_t* words, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    if (_mm512_cmpneq_epi64_mask(avx512_load(words + i), ones) != 0) {
+      return false;
+    }
+  }
+  return scalar_all(words + i, count - i);
+}
+
+BITSET_TARGET_AVX512 bool avx512_any(const uint64_t* words, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i value = avx512_load(words + i);
+    if (_mm512_test_epi64_mask(value, value) != 0) {
+      return true;
+    }
+  }
+  return scalar_any(words + i, count - i);
+}
+
+BITSET_TARGET_AVX512 bool avx512_and_any(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    if (_mm512_test_epi64_mask(avx512_load(lhs + i), avx512_load(rhs + i)) != 0) {
+      return true;
+    }
+  }
+  return scalar_binary_any<word_and>(lhs + i, rhs + i, count - i);
+}
+
+BITSET_TARGET_AVX512 bool avx512_andnot_any(const uint64_t* lhs, const uint64_t* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i difference = avx512_andnot::vector(avx512_load(lhs + i), avx512_load(rhs + i));
+    if (_mm512_test_epi64_mask(difference, difference) != 0) {
+      return true;
+    }
+  }
+  return scalar_binary_any<word_andnot>(lhs + i, rhs + i, count - i);
+}
+
+BITSET_TARGET_AVX512_POPCNT uint64_t avx512_sum_lanes(__m512i total) {
+  uint64_t lanes[8];
+  _mm512_storeu_si512(lanes, total);
+  return std::accumulate(lanes, lanes + 8, uint64_t{0});
+}
+
+template <typename Op>
+BITSET_TARGET_AVX512_POPCNT std::size_t avx512_binary_popcount(
+    const uint64_t* lhs,
+    const uint64_t* rhs,
+    std::size_t count
+) {
+  __m512i total = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i value = Op::vector(_mm512_loadu_si512(lhs + i), _mm512_loadu_si512(rhs + i));
+    total = _mm512_add_epi64(total, _mm512_popcnt_epi64(value));
+  }
+  __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+  __m512i value = Op::vector(_mm512_maskz_loadu_epi64(tail, lhs + i), _mm512_maskz_loadu_epi64(tail, rhs + i));
+  total = _mm512_add_epi64(total, _mm512_popcnt_epi64(value));
+  return static_cast<std::size_t>(avx512_sum_lanes(total));
+}
+
+BITSET_TARGET_AVX512_POPCNT std::size_t avx512_popcount(const uint64_t* words, std::size_t count) {
+  __m512i total = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+  }
+  __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+  total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(tail, words + i)));
+  return static_cast<std::size_t>(avx512_sum_lanes(total));
+}
+
+BITSET_TARGET_AVX512 std::size_t avx512_decode_u32(
+    const uint64_t* words,
+    std::size_t count,
+    uint32_t base,
+    uint32_t* out
+) {
+  const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; ++i, base += 64) {
+    uint64_t word = words[i];
+    if (std::popcount(word) <= SPARSE_DECODE_LIMIT) {
+      written += scalar_decode(&word, 1, base, out + written);
+      continue;
+    }
+    for (unsigned shift = 0; shift < 64; shift += 16) {
+      auto mask = static_cast<__mmask16>(word >> shift);
+      int bits = std::popcount(static_cast<unsigned>(mask));
+      __m512i positions = _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(base + shift)));
+      auto store_mask = static_cast<__mmask16>((1u << bits) - 1);
+      _mm512_mask_storeu_epi32(out + written, store_mask, _mm512_maskz_compress_epi32(mask, positions));
+      written += bits;
+    }
+  }
+  return written;
+}
+
+BITSET_TARGET_AVX512 std::size_t avx512_decode_u64(
+    const uint64_t* words,
+    std::size_t count,
+    uint64_t base,
+    uint64_t* out
+) {
+  const __m512i lanes = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; ++i, base += 64) {
+    uint64_t word = words[i];
+    if (std::popcount(word) <= SPARSE_DECODE_LIMIT) {
+      written += scalar_decode(&word, 1, base, out + written);
+      continue;
+    }
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+      auto mask = static_cast<__mmask8>(word >> shift);
+      int bits = std::popcount(static_cast<unsigned>(mask));
+      __m512i positions = _mm512_add_epi64(lanes, _mm512_set1_epi64(static_cast<long long>(base + shift)));
+      auto store_mask = static_cast<__mmask8>((1u << bits) - 1);
+      _mm512_mask_storeu_epi64(out + written, store_mask, _mm512_maskz_compress_epi64(mask, positions));
+      written += bits;
+    }
+  }
+  return written;
+}
+
+template <uint8_t Function>
+struct avx512_ternary {
+  BITSET_TARGET_AVX512 static void run(
+      uint64_t* dst,
+      const uint64_t* a,
+      const uint64_t* b,
+      const uint64_t* c,
+      std::size_t count
+  ) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      avx512_store(dst + i, _mm512_ternarylogic_epi64(avx512_load(a + i), avx512_load(b + i), avx512_load(c + i), Function));
+    }
+    __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+    __m512i result = _mm512_ternarylogic_epi64(
+        _mm512_maskz_loadu_epi64(tail, a + i),
+        _mm512_maskz_loadu_epi64(tail, b + i),
+        _mm512_maskz_loadu_epi64(tail, c + i),
+        Function
+    );
+    _mm512_mask_storeu_epi64(dst + i, tail, result);
+  }
+};
+
+constexpr std::array<ternary_kernel, 256> avx512_ternary_table =
+    make_ternary_table<avx512_ternary>(std::make_index_sequence<256>());
+
+constexpr bitset_kernels avx512_kernels = {
+    avx512_binary<avx512_and>,
+    avx512_binary<avx512_or>,
+    avx512_binary<avx512_xor>,
+    avx512_binary<avx512_andnot>,
+    avx512_not,
+    avx2_popcount,
+    avx2_binary_popcount<avx2_and>,
+    avx2_binary_popcount<avx2_or>,
+    avx2_binary_popcount<avx2_xor>,
+    avx2_binary_popcount<avx2_andnot>,
+    avx512_and_any,
+    avx512_andnot_any,
+    avx512_equal,
+    avx512_all,
+    avx512_any,
+    avx512_decode_u32,
+    avx512_decode_u64,
+    avx512_ternary_table.data(),
+};
+
+// AVX-512 kernels whose population counts use the VPOPCNTDQ instruction.
+constexpr bitset_kernels with_vpopcntdq(bitset_kernels kernels) {
+  kernels.popcount = avx512_popcount;
+  kernels.and_count = avx512_binary_popcount<avx512_and>;
+  kernels.or_count = avx512_binary_popcount<avx512_or>;
+  kernels.xor_count = avx512_binary_popcount<avx512_xor>;
+  kernels.andnot_count = avx512_binary_popcount<avx512_andnot>;
+  return kernels;
+}
+
+constexpr bitset_kernels avx512_vpopcnt_kernels = with_vpopcntdq(avx512_kernels);
+
+#endif
+
+simd_level cpu_simd_level() {
+#ifdef BITSET_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return simd_level::avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+    return simd_level::avx2;
+  }
+#endif
+  return simd_level::scalar;
+}
+
+simd_level environment_simd_level(simd_level detected) {
+  const char* value = std::getenv("BITSET_SIMD");
+  if (value == nullptr) {
+    return detected;
+  }
+  std::string_view name = value;
+  simd_level requested = detected;
+  if (name == "scalar") {
+    requested = simd_level::scalar;
+  } else if (name == "avx2") {
+    requested = simd_level::avx2;
+  } else if (name == "avx512") {
+    requested = simd_level::avx512;
+  }
+  return std::min(requested, detected);
+}
+
+const bitset_kernels& kernels_for(simd_level level) {
+  switch (level) {
+#ifdef BITSET_SIMD_X86
+  case simd_level::avx512:
+    return __builtin_cpu_supports("avx512vpopcntdq") ? avx512_vpopcnt_kernels : avx512_kernels;
+  case simd_level::avx2:
+    return avx2_kernels;
+#endif
+  default:
+    return scalar_kernels;
+  }
+}
+
+struct dispatch_state {
+  std::atomic<simd_level> level;
+  std::atomic<const bitset_kernels*> kernels;
+
+  dispatch_state()
+      : level(environment_simd_level(detected_simd_level()))
+      , kernels(&kernels_for(level.load())) {}
+};
+
+dispatch_state& dispatch() {
+  static dispatch_state state;
+  return state;
+}
+
+} // namespace
+
+simd_level detected_simd_level() {
+  static const simd_level level = cpu_simd_level();
+  return level;
+}
+
+simd_level active_simd_level() {
+  return dispatch().level.load(std::memory_order_relaxed);
+}
+
+void force_simd_level(simd_level level) {
+  level = std::min(level, detected_simd_level());
+  dispatch_state& state = dispatch();
+  state.level.store(level, std::memory_order_relaxed);
+  state.kernels.store(&kernels_for(level), std::memory_order_relaxed);
+}
+
+const bitset_kernels& active_kernels() {
+  return *dispatch().kernels.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+enum class simd_level {
+  scalar,
+  avx2,
+  avx512,
+};
+
+// Truth tables of the three inputs of a ternary function, in the encoding used
+// by vpternlogq: bit (a << 2 | b << 1 | c) of the table is the result for those
+// input bits. Any function is built by combining them, e.g.
+// `TERNARY_A & (TERNARY_B | ~TERNARY_C)`.
+constexpr uint8_t TERNARY_A = 0xf0;
+constexpr uint8_t TERNARY_B = 0xcc;
+constexpr uint8_t TERNARY_C = 0xaa;
+
+template <uint8_t Function, std::size_t Minterm>
+constexpr uint64_t ternary_minterm(uint64_t a, uint64_t b, uint64_t c) {
+  if constexpr (((Function >> Minterm) & 1) == 0) {
+    return 0;
+  } else {
+    return ((Minterm & 4) ? a : ~a) & ((Minterm & 2) ? b : ~b) & ((Minterm & 1) ? c : ~c);
+  }
+}
+
+template <uint8_t Function, std::size_t... Minterms>
+constexpr uint64_t ternary_word(uint64_t a, uint64_t b, uint64_t c, std::index_sequence<Minterms...>) {
+  return (ternary_minterm<Function, Minterms>(a, b, c) | ...);
+}
+
+// Evaluates the ternary function `Function` on every bit of three words.
+template <uint8_t Function>
+constexpr uint64_t ternary_word(uint64_t a, uint64_t b, uint64_t c) {
+  return ternary_word<Function>(a, b, c, std::make_index_sequence<8>());
+}
+
+using ternary_kernel = void (*)(uint64_t* dst, const uint64_t* a, const uint64_t* b, const uint64_t* c, std::size_t count);
+
+// Bulk kernels over runs of whole 64-bit words. `bitset_view` routes the
+// word-aligned part of its operations through the table chosen at startup.
+struct bitset_kernels {
+  void (*bit_and)(uint64_t* dst, const uint64_t* src, std::size_t count);
+  void (*bit_or)(uint64_t* dst, const uint64_t* src, std::size_t count);
+  void (*bit_xor)(uint64_t* dst, const uint64_t* src, std::size_t count);
+  // dst &= ~src
+  void (*bit_andnot)(uint64_t* dst, const uint64_t* src, std::size_t count);
+  void (*bit_not)(uint64_t* words, std::size_t count);
+  std::size_t (*popcount)(const uint64_t* words, std::size_t count);
+  // Population count of `lhs OP rhs`, where andnot is `lhs & ~rhs`.
+  std::size_t (*and_count)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  std::size_t (*or_count)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  std::size_t (*xor_count)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  std::size_t (*andnot_count)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  // Whether `lhs OP rhs` has any set bit; stops at the first one found.
+  bool (*and_any)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  bool (*andnot_any)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  bool (*equal)(const uint64_t* lhs, const uint64_t* rhs, std::size_t count);
+  bool (*all)(const uint64_t* words, std::size_t count);
+  bool (*any)(const uint64_t* words, std::size_t count);
+  // Writes `base + 64 * i + bit` for every set bit of `words[i]` and returns how many were written.
+  std::size_t (*decode_u32)(const uint64_t* words, std::size_t count, uint32_t base, uint32_t* out);
+  std::size_t (*decode_u64)(const uint64_t* words, std::size_t count, uint64_t base, uint64_t* out);
+  // 256 kernels indexed by truth table, each writing `ternary_word` of the inputs to `dst`.
+  const ternary_kernel* ternary;
+};
+
+// Best level supported by the CPU. Setting BITSET_SIMD=scalar|avx2|avx512 in the
+// environment lowers the level picked at startup.
+simd_level detected_simd_level();
+
+simd_level active_simd_level();
+
+// Switches the kernels used by all bitsets; levels above `detected_simd_level()`
+// are clamped. Intended for tests and benchmarks.
+void force_simd_level(simd_level level);
+
+const bitset_kernels& active_kernels();
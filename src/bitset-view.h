@@ -1,7 +1,10 @@
 #pragma once
 
+#include "bitset-expression.h"
 #include "bitset-iterator.h"
+#include "bitset-positions.h"
 #include "bitset-reference.h"
+#include "bitset-simd.h"
 #include "bitset.h"
 
 #include <bit>
@@ -10,8 +13,10 @@
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 template <typename T>
 class bitset_view {
@@ -71,48 +76,249 @@ public:
   view operator&=(const const_view& other) const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_operation(other, std::bit_and<word_type>());
+    return bitwise_operation(other, std::bit_and<word_type>(), &bitset_kernels::bit_and);
   }
 
   view operator|=(const const_view& other) const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_operation(other, std::bit_or<word_type>());
+    return bitwise_operation(other, std::bit_or<word_type>(), &bitset_kernels::bit_or);
   }
 
   view operator^=(const const_view& other) const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_operation(other, std::bit_xor<word_type>());
+    return bitwise_operation(other, std::bit_xor<word_type>(), &bitset_kernels::bit_xor);
+  }
+
+  // Clears every bit that is set in `other`, i.e. `*this &= ~other` without
+  // materializing the complement.
+  view andnot(const const_view& other) const
+    requires (!std::is_const_v<word_type>)
+  {
+    return bitwise_operation(other, bit_andnot(), &bitset_kernels::bit_andnot);
+  }
+
+  view assign(const const_view& other) const
+    requires (!std::is_const_v<word_type>)
+  {
+    return bitwise_operation(other, [](word_type, word_type other_bits) { return other_bits; }, nullptr);
+  }
+
+  view set_many(std::span<const uint32_t> indices) const
+    requires (!std::is_const_v<word_type>)
+  {
+    return set_indices(indices);
+  }
+
+  view set_many(std::span<const uint64_t> indices) const
+    requires (!std::is_const_v<word_type>)
+  {
+    return set_indices(indices);
   }
 
   view flip() const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_modify(std::bit_xor<word_type>(), BIT_MASK);
+    process_words(
+        [](word_type& word, word_type mask) { word ^= mask; },
+        [](word_type* words, std::size_t count) {
+          if constexpr (HAS_KERNELS) {
+            active_kernels().bit_not(words, count);
+          } else {
+            for (std::size_t i = 0; i < count; ++i) {
+              words[i] = ~words[i];
+            }
+          }
+        }
+    );
+    return *this;
   }
 
   view set() const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_modify(std::bit_or<word_type>(), BIT_MASK);
+    return bitwise_fill(BIT_MASK);
   }
 
   view reset() const
     requires (!std::is_const_v<word_type>)
   {
-    return bitwise_modify(std::bit_and<word_type>(), BIT_MASK_ZERO);
+    return bitwise_fill(BIT_MASK_ZERO);
   }
 
   std::size_t count() const {
     std::size_t result = 0;
-    bitwise_process([&](auto&, word_type current_bits, auto) {
-      result += std::popcount(current_bits);
-      return false;
-    });
+    process_words(
+        [&](word_type& word, word_type mask) { result += std::popcount(static_cast<mutable_word_type>(word & mask)); },
+        [&](word_type* words, std::size_t count) {
+          if constexpr (HAS_KERNELS) {
+            result += active_kernels().popcount(words, count);
+          } else {
+            for (std::size_t i = 0; i < count; ++i) {
+              result += std::popcount(words[i]);
+            }
+          }
+        }
+    );
     return result;
   }
 
+  // Population count of `*this OP other` over size() bits, without building the result.
+  std::size_t and_count(const const_view& other) const {
+    return combined_count<std::bit_and<mutable_word_type>>(other, &bitset_kernels::and_count);
+  }
+
+  std::size_t or_count(const const_view& other) const {
+    return combined_count<std::bit_or<mutable_word_type>>(other, &bitset_kernels::or_count);
+  }
+
+  std::size_t xor_count(const const_view& other) const {
+    return combined_count<std::bit_xor<mutable_word_type>>(other, &bitset_kernels::xor_count);
+  }
+
+  std::size_t andnot_count(const const_view& other) const {
+    return combined_count<bit_andnot>(other, &bitset_kernels::andnot_count);
+  }
+
+  bool intersects(const const_view& other) const {
+    return combined_any<std::bit_and<mutable_word_type>>(other, &bitset_kernels::and_any);
+  }
+
+  bool is_subset_of(const const_view& other) const {
+    return !combined_any<bit_andnot>(other, &bitset_kernels::andnot_any);
+  }
+
+  // Sets every bit to the ternary function `Function` (see TERNARY_A) of the
+  // matching bits of `a`, `b` and `c`, in a single pass.
+  template <uint8_t Function>
+  view ternary(const const_view& a, const const_view& b, const const_view& c) const
+    requires (!std::is_const_v<word_type>)
+  {
+    if constexpr (HAS_KERNELS) {
+      if (get_bit_offset() == 0 && a.get_bit_offset() == 0 && b.get_bit_offset() == 0 && c.get_bit_offset() == 0) {
+        word_type* dst = get_word_ptr();
+        const word_type* a_words = a.get_word_ptr();
+        const word_type* b_words = b.get_word_ptr();
+        const word_type* c_words = c.get_word_ptr();
+        std::size_t full_words = size() / BITS_PER_WORD;
+        active_kernels().ternary[Function](dst, a_words, b_words, c_words, full_words);
+        if (std::size_t tail = size() % BITS_PER_WORD; tail != 0) {
+          word_type result = ternary_word<Function>(a_words[full_words], b_words[full_words], c_words[full_words]);
+          store_masked(dst[full_words], result, iterator::create_mask(tail));
+        }
+        return *this;
+      }
+    }
+    return apply(
+        [](mutable_word_type x, mutable_word_type y, mutable_word_type z) { return ternary_word<Function>(x, y, z); },
+        a,
+        b,
+        c
+    );
+  }
+
+  // Sets every bit from `function`, which maps three words of `a`, `b` and `c`
+  // to one word of the result.
+  template <typename Function>
+  view apply(Function function, const const_view& a, const const_view& b, const const_view& c) const
+    requires (!std::is_const_v<word_type>)
+  {
+    std::size_t head = get_bit_offset() == 0 ? 0 : std::min(size(), BITS_PER_WORD - get_bit_offset());
+    if (head != 0) {
+      word_type result = function(a.begin().get_n_bits(head), b.begin().get_n_bits(head), c.begin().get_n_bits(head));
+      begin().change_n_bits(result, head);
+    }
+    bitset_leaf_expression a_words(a.subview(head));
+    bitset_leaf_expression b_words(b.subview(head));
+    bitset_leaf_expression c_words(c.subview(head));
+    word_type* dst = get_word_ptr() + (head != 0 ? 1 : 0);
+    std::size_t remaining_bits = size() - head;
+    std::size_t full_words = remaining_bits / BITS_PER_WORD;
+    for (std::size_t i = 0; i < full_words; ++i) {
+      dst[i] = function(a_words.word(i), b_words.word(i), c_words.word(i));
+    }
+    if (std::size_t tail = remaining_bits % BITS_PER_WORD; tail != 0) {
+      word_type result = function(a_words.word(full_words), b_words.word(full_words), c_words.word(full_words));
+      store_masked(dst[full_words], result, iterator::create_mask(tail));
+    }
+    return *this;
+  }
+
+  std::size_t find_first() const {
+    return find_forward(0, true);
+  }
+
+  std::size_t find_next(std::size_t pos) const {
+    return pos >= size() ? npos : find_forward(pos + 1, true);
+  }
+
+  std::size_t find_last() const {
+    return find_backward(size(), true);
+  }
+
+  std::size_t find_prev(std::size_t pos) const {
+    return find_backward(pos, true);
+  }
+
+  std::size_t find_first_zero() const {
+    return find_forward(0, false);
+  }
+
+  std::size_t find_next_zero(std::size_t pos) const {
+    return pos >= size() ? npos : find_forward(pos + 1, false);
+  }
+
+  std::size_t find_last_zero() const {
+    return find_backward(size(), false);
+  }
+
+  std::size_t find_prev_zero(std::size_t pos) const {
+    return find_backward(pos, false);
+  }
+
+  bitset_positions<const word_type, true> ones() const {
+    return positions<true>();
+  }
+
+  bitset_positions<const word_type, false> zeros() const {
+    return positions<false>();
+  }
+
+  // Writes the index of every set bit to `out`, which must have room for count()
+  // entries, and returns the number of indices written.
+  template <typename Index>
+  std::size_t to_indices(Index* out) const {
+    std::size_t written = 0;
+    word_type* first_word = get_word_ptr();
+    auto base_of = [&](word_type* word) {
+      return static_cast<Index>(static_cast<std::size_t>(word - first_word) * BITS_PER_WORD - get_bit_offset());
+    };
+    process_words(
+        [&](word_type& word, word_type mask) {
+          mutable_word_type bits = word & mask;
+          for (Index base = base_of(&word); bits != 0; bits &= bits - 1) {
+            out[written++] = base + static_cast<Index>(std::countr_zero(bits));
+          }
+        },
+        [&](word_type* words, std::size_t count) {
+          if constexpr (HAS_KERNELS && std::is_same_v<Index, uint32_t>) {
+            written += active_kernels().decode_u32(words, count, base_of(words), out + written);
+          } else if constexpr (HAS_KERNELS && std::is_same_v<Index, uint64_t>) {
+            written += active_kernels().decode_u64(words, count, base_of(words), out + written);
+          } else {
+            Index base = base_of(words);
+            for (std::size_t i = 0; i < count; ++i, base += BITS_PER_WORD) {
+              for (mutable_word_type bits = words[i]; bits != 0; bits &= bits - 1) {
+                out[written++] = base + static_cast<Index>(std::countr_zero(bits));
+              }
+            }
+          }
+        }
+    );
+    return written;
+  }
+
   view subview(std::size_t offset = 0, std::size_t count = npos) const {
     if (offset > size()) {
       return bitset_view<word_type>(end(), end());
@@ -126,19 +332,30 @@ public:
     if (size() != other.size()) {
       return false;
     }
-    bool result = true;
+    if (empty()) {
+      return true;
+    }
+    const_iterator it_this = begin();
     const_iterator it_other = other.begin();
-    auto check_function = [&](auto&, word_type current_bits, std::size_t num_bits) {
-      word_type word_other = it_other.get_n_bits(num_bits);
-      if (word_other != current_bits) {
-        result = false;
-        return true;
+    std::size_t remaining_bits = size();
+    if (it_this.get_offset() != 0) {
+      std::size_t head_bits = std::min(remaining_bits, BITS_PER_WORD - it_this.get_offset());
+      if (it_this.get_n_bits(head_bits) != it_other.get_n_bits(head_bits)) {
+        return false;
       }
-      std::advance(it_other, num_bits);
-      return false;
-    };
-    bitwise_process(check_function);
-    return result;
+      std::advance(it_this, head_bits);
+      std::advance(it_other, head_bits);
+      remaining_bits -= head_bits;
+    }
+    if (remaining_bits == 0) {
+      return true;
+    }
+    const word_type* lhs = it_this._wordPtr + it_this.get_word();
+    const word_type* rhs = it_other._wordPtr + it_other.get_word();
+    if (it_other.get_offset() == 0) {
+      return equal_aligned(lhs, rhs, remaining_bits);
+    }
+    return equal_shifted(lhs, rhs, it_other.get_offset(), remaining_bits);
   }
 
   bool operator!=(const bitset_view<const word_type>& other) const {
@@ -146,71 +363,349 @@ public:
   }
 
   bool all() const {
-    return bitwise_check([](word_type bits) { return ~bits != 0; }, false);
+    bool result = true;
+    process_words(
+        [&](word_type& word, word_type mask) { result = result && (word & mask) == mask; },
+        [&](word_type* words, std::size_t count) {
+          if constexpr (HAS_KERNELS) {
+            result = result && active_kernels().all(words, count);
+          } else {
+            result = result && std::all_of(words, words + count, [](word_type word) { return ~word == 0; });
+          }
+        }
+    );
+    return result;
   }
 
   bool any() const {
-    if (empty()) {
-      return false;
-    }
-    return bitwise_check([](word_type bits) { return bits != 0; }, true);
+    bool result = false;
+    process_words(
+        [&](word_type& word, word_type mask) { result = result || (word & mask) != 0; },
+        [&](word_type* words, std::size_t count) {
+          if constexpr (HAS_KERNELS) {
+            result = result || active_kernels().any(words, count);
+          } else {
+            result = result || std::any_of(words, words + count, [](word_type word) { return word != 0; });
+          }
+        }
+    );
+    return result;
   }
 
 private:
+  template <typename>
+  friend class bitset_view;
+  friend class bitset_leaf_expression;
+  friend class bitset_chunks;
+
+  using mutable_word_type = std::remove_const_t<word_type>;
+  using kernel_type = void (*)(uint64_t*, const uint64_t*, std::size_t);
+  using count_kernel_type = std::size_t (*)(const uint64_t*, const uint64_t*, std::size_t);
+  using any_kernel_type = bool (*)(const uint64_t*, const uint64_t*, std::size_t);
+
+  static constexpr bool HAS_KERNELS = std::is_same_v<mutable_word_type, uint64_t>;
+
   iterator _first;
   iterator _last;
 
-  template <typename Function>
-  void bitwise_process(Function function) const {
-    iterator it = begin();
-    while (it < end()) {
-      auto remaining_bits = static_cast<std::size_t>(end() - it);
-      std::size_t num_bits = std::min(BITS_PER_WORD, remaining_bits);
-      word_type current_bits = it.get_n_bits(num_bits);
-      if (function(it, current_bits, num_bits)) {
-        break;
+  template <typename Operation>
+  auto combine_lazily(const const_view& other) const {
+    using leaf = bitset_leaf_expression;
+    return bitset_binary_expression<Operation, leaf, leaf>(leaf(*this), leaf(other));
+  }
+
+  template <typename Operation>
+  std::size_t combined_count(const const_view& other, count_kernel_type bitset_kernels::*kernel) const {
+    if constexpr (HAS_KERNELS) {
+      if (get_bit_offset() == 0 && other.get_bit_offset() == 0) {
+        const word_type* lhs = get_word_ptr();
+        const word_type* rhs = other.get_word_ptr();
+        std::size_t full_words = size() / BITS_PER_WORD;
+        std::size_t result = (active_kernels().*kernel)(lhs, rhs, full_words);
+        if (std::size_t tail = size() % BITS_PER_WORD; tail != 0) {
+          result += std::popcount(Operation()(lhs[full_words], rhs[full_words]) & iterator::create_mask(tail));
+        }
+        return result;
       }
-      std::advance(it, num_bits);
     }
+    return combine_lazily<Operation>(other).count();
   }
 
   template <typename Operation>
-  view bitwise_operation(const const_view& other, Operation operation) const {
-    const_iterator it_other = other.begin();
-    bitwise_process([&](iterator& it_this, word_type current_bits, std::size_t num_bits) {
-      word_type word_other = it_other.get_n_bits(num_bits);
-      it_this.change_n_bits(operation(current_bits, word_other), num_bits);
-      std::advance(it_other, num_bits);
-      return false;
-    });
+  bool combined_any(const const_view& other, any_kernel_type bitset_kernels::*kernel) const {
+    if constexpr (HAS_KERNELS) {
+      if (get_bit_offset() == 0 && other.get_bit_offset() == 0) {
+        const word_type* lhs = get_word_ptr();
+        const word_type* rhs = other.get_word_ptr();
+        std::size_t full_words = size() / BITS_PER_WORD;
+        if ((active_kernels().*kernel)(lhs, rhs, full_words)) {
+          return true;
+        }
+        std::size_t tail = size() % BITS_PER_WORD;
+        return tail != 0 && (Operation()(lhs[full_words], rhs[full_words]) & iterator::create_mask(tail)) != 0;
+      }
+    }
+    return combine_lazily<Operation>(other).any();
+  }
+
+  word_type* get_word_ptr() const {
+    return _first._wordPtr + _first.get_word();
+  }
+
+  std::size_t get_bit_offset() const {
+    return _first.get_offset();
+  }
+
+  static void store_masked(mutable_word_type& word, word_type bits, word_type mask) {
+    word = (word & ~mask) | (bits & mask);
+  }
+
+  static constexpr std::size_t SET_MANY_PREFETCH_DISTANCE = 16;
+
+  // Bits falling into the same word are accumulated in a register and stored
+  // once, so sorted input touches every word a single time. Whenever the target
+  // word changes, the word needed a few indices ahead is prefetched to hide the
+  // cache misses of unsorted input.
+  template <typename Index>
+  view set_indices(std::span<const Index> indices) const {
+    if (indices.empty()) {
+      return *this;
+    }
+    word_type* words = get_word_ptr();
+    std::size_t offset = get_bit_offset();
+    std::size_t pending_word = (offset + indices[0]) / BITS_PER_WORD;
+    mutable_word_type pending_bits = 0;
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      std::size_t bit = offset + indices[i];
+      std::size_t word = bit / BITS_PER_WORD;
+      if (word != pending_word) {
+        words[pending_word] |= pending_bits;
+        pending_word = word;
+        pending_bits = 0;
+#if defined(__GNUC__) || defined(__clang__)
+        if (i + SET_MANY_PREFETCH_DISTANCE < indices.size()) {
+          __builtin_prefetch(words + (offset + indices[i + SET_MANY_PREFETCH_DISTANCE]) / BITS_PER_WORD, 1);
+        }
+#endif
+      }
+      pending_bits |= mutable_word_type{1} << (bit % BITS_PER_WORD);
+    }
+    words[pending_word] |= pending_bits;
     return *this;
   }
 
+  template <bool Value>
+  bitset_positions<const word_type, Value> positions() const {
+    if (empty()) {
+      return {};
+    }
+    return {get_word_ptr(), get_bit_offset(), get_bit_offset() + size()};
+  }
+
+  mutable_word_type load_word(std::size_t index, bool value) const {
+    word_type word = get_word_ptr()[index];
+    return value ? word : ~word;
+  }
+
+  // First index in [from, size()) holding `value`, or npos.
+  std::size_t find_forward(std::size_t from, bool value) const {
+    if (from >= size()) {
+      return npos;
+    }
+    std::size_t first = get_bit_offset() + from;
+    std::size_t last = get_bit_offset() + size();
+    std::size_t last_word = (last - 1) / BITS_PER_WORD;
+    std::size_t word = first / BITS_PER_WORD;
+    mutable_word_type bits = load_word(word, value) & (BIT_MASK << (first % BITS_PER_WORD));
+    while (true) {
+      if (word == last_word) {
+        bits &= iterator::create_mask(last - last_word * BITS_PER_WORD);
+      }
+      if (bits != 0) {
+        return word * BITS_PER_WORD + std::countr_zero(bits) - get_bit_offset();
+      }
+      if (word == last_word) {
+        return npos;
+      }
+      bits = load_word(++word, value);
+    }
+  }
+
+  // Last index in [0, min(to, size())) holding `value`, or npos.
+  std::size_t find_backward(std::size_t to, bool value) const {
+    to = std::min(to, size());
+    if (to == 0) {
+      return npos;
+    }
+    std::size_t last = get_bit_offset() + to;
+    std::size_t word = (last - 1) / BITS_PER_WORD;
+    mutable_word_type bits = load_word(word, value) & iterator::create_mask(last - word * BITS_PER_WORD);
+    while (true) {
+      if (word == 0) {
+        bits &= BIT_MASK << get_bit_offset();
+      }
+      if (bits != 0) {
+        return word * BITS_PER_WORD + (BITS_PER_WORD - 1 - std::countl_zero(bits)) - get_bit_offset();
+      }
+      if (word == 0) {
+        return npos;
+      }
+      bits = load_word(--word, value);
+    }
+  }
+
+  // Calls `edge(word, mask)` for the partially covered first and last words and
+  // `body(words, count)` once for the run of fully covered words in between.
+  template <typename EdgeFunction, typename BodyFunction>
+  void process_words(EdgeFunction edge, BodyFunction body) const {
+    if (empty()) {
+      return;
+    }
+    word_type* words = get_word_ptr();
+    std::size_t offset = get_bit_offset();
+    std::size_t last = offset + size();
+    if (last <= BITS_PER_WORD) {
+      edge(words[0], iterator::create_mask(size()) << offset);
+      return;
+    }
+    std::size_t first_full = 0;
+    if (offset != 0) {
+      edge(words[0], BIT_MASK << offset);
+      first_full = 1;
+    }
+    std::size_t last_full = last / BITS_PER_WORD;
+    body(words + first_full, last_full - first_full);
+    if (last % BITS_PER_WORD != 0) {
+      edge(words[last_full], iterator::create_mask(last % BITS_PER_WORD));
+    }
+  }
+
   template <typename Operation>
-  view bitwise_modify(Operation operation, word_type mask) const {
-    bitwise_process([&](iterator& it, word_type current_bits, std::size_t num_bits) {
-      it.change_n_bits(operation(current_bits, mask), num_bits);
-      return false;
-    });
+  view bitwise_operation(const const_view& other, Operation operation, kernel_type bitset_kernels::*kernel) const {
+    if (empty()) {
+      return *this;
+    }
+    iterator it_this = begin();
+    const_iterator it_other = other.begin();
+    std::size_t remaining_bits = size();
+    if (it_this.get_offset() != 0) {
+      std::size_t head_bits = std::min(remaining_bits, BITS_PER_WORD - it_this.get_offset());
+      it_this.change_n_bits(operation(it_this.get_n_bits(head_bits), it_other.get_n_bits(head_bits)), head_bits);
+      std::advance(it_this, head_bits);
+      std::advance(it_other, head_bits);
+      remaining_bits -= head_bits;
+    }
+    if (remaining_bits == 0) {
+      return *this;
+    }
+    word_type* dst = it_this._wordPtr + it_this.get_word();
+    const word_type* src = it_other._wordPtr + it_other.get_word();
+    if (it_other.get_offset() == 0) {
+      bitwise_operation_aligned(dst, src, remaining_bits, operation, kernel);
+    } else {
+      bitwise_operation_shifted(dst, src, it_other.get_offset(), remaining_bits, operation);
+    }
     return *this;
   }
 
   template <typename Operation>
-  bool bitwise_check(Operation function, bool ans) const {
-    bool result = !ans;
-    auto checker = [&](auto&, word_type current_bits, std::size_t num_bits) {
-      if (!ans && (num_bits < BITS_PER_WORD)) {
-        result = ((current_bits ^ iterator::create_mask(num_bits)) == 0);
-        return true;
+  static void bitwise_operation_aligned(
+      word_type* dst,
+      const word_type* src,
+      std::size_t num_bits,
+      Operation operation,
+      kernel_type bitset_kernels::*kernel
+  ) {
+    std::size_t full_words = num_bits / BITS_PER_WORD;
+    if constexpr (HAS_KERNELS) {
+      if (kernel != nullptr) {
+        (active_kernels().*kernel)(dst, src, full_words);
+      } else {
+        for (std::size_t i = 0; i < full_words; ++i) {
+          dst[i] = operation(dst[i], src[i]);
+        }
       }
-      if (function(current_bits)) {
-        result = ans;
-        return true;
+    } else {
+      for (std::size_t i = 0; i < full_words; ++i) {
+        dst[i] = operation(dst[i], src[i]);
       }
-      return false;
-    };
-    bitwise_process(checker);
-    return result;
+    }
+    std::size_t tail_bits = num_bits % BITS_PER_WORD;
+    if (tail_bits != 0) {
+      store_masked(dst[full_words], operation(dst[full_words], src[full_words]), iterator::create_mask(tail_bits));
+    }
+  }
+
+  // `dst` is word-aligned and `src` starts `shift` bits into its first word: every
+  // destination word is a funnel shift of two neighbouring source words.
+  template <typename Operation>
+  static void bitwise_operation_shifted(
+      word_type* dst,
+      const word_type* src,
+      std::size_t shift,
+      std::size_t num_bits,
+      Operation operation
+  ) {
+    std::size_t full_words = num_bits / BITS_PER_WORD;
+    if (full_words != 0) {
+      mutable_word_type low = src[0];
+      for (std::size_t i = 0; i < full_words; ++i) {
+        word_type high = src[i + 1];
+        dst[i] = operation(dst[i], (low >> shift) | (high << (BITS_PER_WORD - shift)));
+        low = high;
+      }
+    }
+    std::size_t tail_bits = num_bits % BITS_PER_WORD;
+    if (tail_bits != 0) {
+      const_iterator tail(src, full_words * BITS_PER_WORD + shift);
+      store_masked(
+          dst[full_words],
+          operation(dst[full_words], tail.get_n_bits(tail_bits)),
+          iterator::create_mask(tail_bits)
+      );
+    }
+  }
+
+  static bool equal_aligned(const word_type* lhs, const word_type* rhs, std::size_t num_bits) {
+    std::size_t full_words = num_bits / BITS_PER_WORD;
+    bool body_equal;
+    if constexpr (HAS_KERNELS) {
+      body_equal = active_kernels().equal(lhs, rhs, full_words);
+    } else {
+      body_equal = std::equal(lhs, lhs + full_words, rhs);
+    }
+    std::size_t tail_bits = num_bits % BITS_PER_WORD;
+    if (!body_equal || tail_bits == 0) {
+      return body_equal;
+    }
+    return ((lhs[full_words] ^ rhs[full_words]) & iterator::create_mask(tail_bits)) == 0;
+  }
+
+  // Counterpart of bitwise_operation_shifted for comparisons.
+  static bool equal_shifted(const word_type* lhs, const word_type* rhs, std::size_t shift, std::size_t num_bits) {
+    std::size_t full_words = num_bits / BITS_PER_WORD;
+    mutable_word_type low = rhs[0];
+    for (std::size_t i = 0; i < full_words; ++i) {
+      mutable_word_type high = rhs[i + 1];
+      if (lhs[i] != ((low >> shift) | (high << (BITS_PER_WORD - shift)))) {
+        return false;
+      }
+      low = high;
+    }
+    std::size_t tail_bits = num_bits % BITS_PER_WORD;
+    if (tail_bits == 0) {
+      return true;
+    }
+    const_iterator tail(rhs, full_words * BITS_PER_WORD + shift);
+    return ((lhs[full_words] ^ tail.get_n_bits(tail_bits)) & iterator::create_mask(tail_bits)) == 0;
+  }
+
+  view bitwise_fill(word_type value) const {
+    process_words(
+        [&](word_type& word, word_type word_mask) { store_masked(word, value, word_mask); },
+        [&](word_type* words, std::size_t count) { std::fill_n(words, count, value); }
+    );
+    return *this;
   }
 };
 
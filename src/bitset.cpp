@@ -1,18 +1,31 @@
 #include "bitset.h"
 
+#include <new>
+#include <utility>
+
 bitset::bitset() = default;
 
 bitset::bitset(std::size_t size)
     : bit_count(size)
+    , word_capacity(word_count(size))
     , words(allocate_memory(size)) {}
 
+std::size_t bitset::word_count(std::size_t size) {
+  return (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+bool bitset::can_hold(std::size_t size) const {
+  std::size_t needed = word_count(size);
+  return word_capacity >= needed && word_capacity - needed <= MAX_SPARE_WORDS;
+}
+
 bitset::word_type* bitset::allocate_memory(std::size_t size) {
-  return size == 0 ? nullptr : new bitset::word_type[(size + BITS_PER_WORD - 1) / BITS_PER_WORD];
+  return size == 0 ? nullptr : new (std::align_val_t(STORAGE_ALIGNMENT)) bitset::word_type[word_count(size)];
 }
 
 bitset::bitset(std::size_t size, bool value)
     : bitset(size) {
-  std::size_t num_words = (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  std::size_t num_words = word_count(size);
   std::fill(words, words + num_words, (value) ? std::numeric_limits<word_type>::max() : static_cast<word_type>(0));
   std::size_t remaining_bits = size % BITS_PER_WORD;
   if (remaining_bits > 0) {
@@ -23,14 +36,17 @@ bitset::bitset(std::size_t size, bool value)
 
 bitset::bitset(const bitset& other)
     : bitset(other.size()) {
-  iterator begin = {words, 0};
-  std::copy(other.begin(), other.end(), begin);
+  std::copy_n(other.words, word_count(bit_count), words);
 }
 
+bitset::bitset(bitset&& other) noexcept
+    : bit_count(std::exchange(other.bit_count, 0))
+    , word_capacity(std::exchange(other.word_capacity, 0))
+    , words(std::exchange(other.words, nullptr)) {}
+
 bitset::bitset(const bitset::const_view& other)
     : bitset(other.size()) {
-  iterator begin = {words, 0};
-  std::copy(other.begin(), other.end(), begin);
+  subview().assign(other);
 }
 
 bitset::bitset(std::string_view str)
@@ -45,19 +61,36 @@ bitset::bitset(std::string_view str)
 bitset::bitset(bitset::const_iterator first, bitset::const_iterator last)
     : bitset(const_view(first, last)) {}
 
+bitset bitset::from_indices(std::size_t size, std::span<const uint32_t> indices) {
+  bitset result(size, false);
+  result.set_many(indices);
+  return result;
+}
+
+bitset bitset::from_indices(std::size_t size, std::span<const uint64_t> indices) {
+  bitset result(size, false);
+  result.set_many(indices);
+  return result;
+}
+
 bitset::~bitset() {
-  delete[] words;
+  ::operator delete[](words, std::align_val_t(STORAGE_ALIGNMENT));
 }
 
 void bitset::swap(bitset& other) noexcept {
   std::swap(words, other.words);
   std::swap(bit_count, other.bit_count);
+  std::swap(word_capacity, other.word_capacity);
 }
 
 std::size_t bitset::size() const {
   return bit_count;
 }
 
+std::size_t bitset::capacity() const {
+  return word_capacity * BITS_PER_WORD;
+}
+
 bool bitset::empty() const {
   return (bit_count == 0);
 }
@@ -116,6 +149,12 @@ bitset& bitset::operator^=(const const_view& other) & {
   return *this;
 }
 
+bitset& bitset::andnot(const const_view& other) & {
+  view this_view = subview();
+  this_view.andnot(other);
+  return *this;
+}
+
 bitset::reference bitset::operator[](std::size_t index) {
   iterator it = begin();
   return it[static_cast<difference_type>(index)];
@@ -138,6 +177,56 @@ std::size_t bitset::count() const {
   return this->operator const_view().count();
 }
 
+bitset_positions<const bitset::word_type, true> bitset::ones() const {
+  return this->operator const_view().ones();
+}
+
+bitset_positions<const bitset::word_type, false> bitset::zeros() const {
+  return this->operator const_view().zeros();
+}
+
+std::size_t bitset::find_first() const {
+  return this->operator const_view().find_first();
+}
+
+std::size_t bitset::find_next(std::size_t pos) const {
+  return this->operator const_view().find_next(pos);
+}
+
+std::size_t bitset::find_last() const {
+  return this->operator const_view().find_last();
+}
+
+std::size_t bitset::find_prev(std::size_t pos) const {
+  return this->operator const_view().find_prev(pos);
+}
+
+std::size_t bitset::find_first_zero() const {
+  return this->operator const_view().find_first_zero();
+}
+
+std::size_t bitset::find_next_zero(std::size_t pos) const {
+  return this->operator const_view().find_next_zero(pos);
+}
+
+std::size_t bitset::find_last_zero() const {
+  return this->operator const_view().find_last_zero();
+}
+
+std::size_t bitset::find_prev_zero(std::size_t pos) const {
+  return this->operator const_view().find_prev_zero(pos);
+}
+
+bitset& bitset::set_many(std::span<const uint32_t> indices) & {
+  this->operator view().set_many(indices);
+  return *this;
+}
+
+bitset& bitset::set_many(std::span<const uint64_t> indices) & {
+  this->operator view().set_many(indices);
+  return *this;
+}
+
 bitset& bitset::flip() & {
   this->operator view().flip();
   return *this;
@@ -159,6 +248,12 @@ bitset& bitset::operator=(const bitset& other) & {
   return *this;
 }
 
+bitset& bitset::operator=(bitset&& other) & noexcept {
+  bitset temp = std::move(other);
+  swap(temp);
+  return *this;
+}
+
 bitset& bitset::operator=(std::string_view str) & {
   bitset temp = bitset(str);
   swap(temp);
@@ -171,74 +266,86 @@ bitset& bitset::operator=(const bitset::const_view& other) & {
   return *this;
 }
 
-bitset operator&(const bitset& lhs, const bitset& rhs) {
-  bitset result = lhs;
-  return (result &= rhs);
+bool operator==(const bitset& left, const bitset& right) {
+  return bitset::const_view(left) == bitset::const_view(right);
 }
 
-bitset operator|(const bitset& lhs, const bitset& rhs) {
-  bitset result = lhs;
-  return (result |= rhs);
+bool operator!=(const bitset& left, const bitset& right) {
+  return !(left == right);
 }
 
-bitset operator^(const bitset& lhs, const bitset& rhs) {
-  bitset result = lhs;
-  return (result ^= rhs);
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.and_count(rhs);
 }
 
-bool operator==(const bitset& left, const bitset& right) {
-  return bitset::const_view(left) == bitset::const_view(right);
+std::size_t or_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.or_count(rhs);
 }
 
-bool operator!=(const bitset& left, const bitset& right) {
-  return !(left == right);
+std::size_t xor_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.xor_count(rhs);
 }
 
-std::string to_string(const bitset& bs) {
-  return to_string(bitset::const_view(bs));
+std::size_t andnot_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.andnot_count(rhs);
 }
 
-std::ostream& operator<<(std::ostream& out, const bitset& bs) {
-  return out << bitset::const_view(bs);
+bool intersects(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.intersects(rhs);
 }
 
-bitset operator<<(const bitset& bs, std::size_t count) {
-  bitset result = bs;
-  return (result <<= count);
+bool is_subset_of(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.is_subset_of(rhs);
 }
 
-bitset operator>>(const bitset& bs, std::size_t count) {
-  bitset result = bs;
-  return (result >>= count);
+std::size_t to_indices(const bitset::const_view& bs, uint32_t* out) {
+  return bs.to_indices(out);
 }
 
-bitset operator~(const bitset& bs) {
-  bitset temp = bitset(bs.size(), true);
-  auto bs_view = bitset::const_view(bs);
-  temp ^= bs_view;
-  return temp;
+std::size_t to_indices(const bitset::const_view& bs, uint64_t* out) {
+  return bs.to_indices(out);
 }
 
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result ^= rhs;
+std::vector<uint32_t> to_indices(const bitset::const_view& bs) {
+  std::vector<uint32_t> result(bs.count());
+  bs.to_indices(result.data());
   return result;
 }
 
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result |= rhs;
+std::vector<uint64_t> to_indices64(const bitset::const_view& bs) {
+  std::vector<uint64_t> result(bs.count());
+  bs.to_indices(result.data());
   return result;
 }
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result &= rhs;
+std::string to_string(const bitset& bs) {
+  return to_string(bitset::const_view(bs));
+}
+
+std::ostream& operator<<(std::ostream& out, const bitset& bs) {
+  return out << bitset::const_view(bs);
+}
+
+bitset operator<<(const bitset& bs, std::size_t count) {
+  bitset result = bs;
+  result <<= count;
+  return result;
+}
+
+bitset operator<<(bitset&& bs, std::size_t count) {
+  bs <<= count;
+  return std::move(bs);
+}
+
+bitset operator>>(const bitset& bs, std::size_t count) {
+  bitset result = bs;
+  result >>= count;
   return result;
 }
 
-bitset operator~(const bitset::const_view& bsv) {
-  return ~bitset(bsv);
+bitset operator>>(bitset&& bs, std::size_t count) {
+  bs >>= count;
+  return std::move(bs);
 }
 
 bitset operator<<(const bitset::const_view& bs_v, std::size_t count) {
@@ -249,34 +356,24 @@ bitset operator>>(const bitset::const_view& bs_v, std::size_t count) {
   return bitset(bs_v) >> count;
 }
 
-bitset& bitset::shift(std::size_t count, bool is_right) & {
-  std::size_t new_size = (is_right) ? (size() - count) : (size() + count);
-  bitset new_bitset = bitset(new_size, false);
-  iterator out_it = new_bitset.begin();
-  iterator new_end = (is_right) ? (end() - static_cast<difference_type>(count)) : end();
-  iterator it = begin();
-  while (it < new_end) {
-    auto remaining_bits = static_cast<std::size_t>(end() - it);
-    std::size_t num_bits = std::min(BITS_PER_WORD, remaining_bits);
-    out_it.change_n_bits(it.get_n_bits(num_bits), num_bits);
-    std::advance(it, num_bits);
-    std::advance(out_it, num_bits);
-  }
-  *this = new_bitset;
-  return *this;
-}
-
 bitset& bitset::operator>>=(std::size_t count) & {
-  if (empty()) {
-    return *this;
-  }
-  if (size() < count) {
-    *this = bitset();
-    return *this;
+  bit_count -= std::min(count, bit_count);
+  if (!can_hold(bit_count)) {
+    bitset shrunk(std::as_const(*this).subview());
+    swap(shrunk);
   }
-  return bitset::shift(count, true);
+  return *this;
 }
 
 bitset& bitset::operator<<=(std::size_t count) & {
-  return bitset::shift(count, false);
+  std::size_t old_size = bit_count;
+  std::size_t new_size = old_size + count;
+  if (word_count(new_size) > word_capacity) {
+    bitset grown(new_size);
+    std::copy_n(words, word_count(old_size), grown.words);
+    swap(grown);
+  }
+  bit_count = new_size;
+  subview(old_size).reset();
+  return *this;
 }
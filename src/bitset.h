@@ -1,12 +1,17 @@
 #pragma once
 
+#include "bitset-algorithm.h"
+#include "bitset-expression.h"
 #include "bitset-iterator.h"
+#include "bitset-positions.h"
 #include "bitset-reference.h"
 #include "bitset-view.h"
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string_view>
+#include <vector>
 
 class bitset {
 public:
@@ -26,20 +31,40 @@ public:
   bitset();
   bitset(std::size_t size, bool value);
   bitset(const bitset& other);
+  bitset(bitset&& other) noexcept;
 
   explicit bitset(std::string_view str);
   explicit bitset(const const_view& other);
   bitset(const_iterator first, const_iterator last);
 
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset(Expression&& expression) {
+    assign_expression(std::forward<Expression>(expression));
+  }
+
   bitset& operator=(const bitset& other) &;
+  bitset& operator=(bitset&& other) & noexcept;
   bitset& operator=(std::string_view str) &;
   bitset& operator=(const const_view& other) &;
 
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset& operator=(Expression&& expression) & {
+    assign_expression(std::forward<Expression>(expression));
+    return *this;
+  }
+
+  static bitset from_indices(std::size_t size, std::span<const uint32_t> indices);
+  static bitset from_indices(std::size_t size, std::span<const uint64_t> indices);
+
   ~bitset();
 
   void swap(bitset& other) noexcept;
 
   std::size_t size() const;
+  // Number of bits the current buffer can hold without reallocating.
+  std::size_t capacity() const;
 
   bool empty() const;
 
@@ -55,10 +80,38 @@ public:
   bitset& operator&=(const const_view& other) &;
   bitset& operator|=(const const_view& other) &;
   bitset& operator^=(const const_view& other) &;
+  bitset& andnot(const const_view& other) &;
+
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset& operator&=(Expression&& expression) & {
+    return *this = std::move(*this) & std::forward<Expression>(expression);
+  }
+
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset& operator|=(Expression&& expression) & {
+    return *this = std::move(*this) | std::forward<Expression>(expression);
+  }
+
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset& operator^=(Expression&& expression) & {
+    return *this = std::move(*this) ^ std::forward<Expression>(expression);
+  }
+
+  template <typename Expression>
+    requires is_bitset_expression<Expression>
+  bitset& andnot(Expression&& expression) & {
+    return *this = ::andnot(std::move(*this), std::forward<Expression>(expression));
+  }
 
   bitset& operator<<=(std::size_t count) &;
   bitset& operator>>=(std::size_t count) &;
 
+  bitset& set_many(std::span<const uint32_t> indices) &;
+  bitset& set_many(std::span<const uint64_t> indices) &;
+
   bitset& flip() &;
 
   bitset& set() &;
@@ -68,6 +121,19 @@ public:
   bool any() const;
   std::size_t count() const;
 
+  bitset_positions<const word_type, true> ones() const;
+  bitset_positions<const word_type, false> zeros() const;
+
+  std::size_t find_first() const;
+  std::size_t find_next(std::size_t pos) const;
+  std::size_t find_last() const;
+  std::size_t find_prev(std::size_t pos) const;
+
+  std::size_t find_first_zero() const;
+  std::size_t find_next_zero(std::size_t pos) const;
+  std::size_t find_last_zero() const;
+  std::size_t find_prev_zero(std::size_t pos) const;
+
   operator const_view() const;
   operator view();
 
@@ -75,33 +141,76 @@ public:
   const_view subview(std::size_t offset = 0, std::size_t count = npos) const;
 
 private:
-  bitset& shift(size_t count, bool is_right) &;
   size_t bit_count = 0;
+  size_t word_capacity = 0;
   word_type* words = nullptr;
 
+  // Storage starts on a cache line so that aligned chunks of a bitset never
+  // share a line with their neighbours.
+  static constexpr std::size_t STORAGE_ALIGNMENT = 64;
+  // Unused words a bitset may keep after shrinking, so that memory stays
+  // within `size() + C` bits.
+  static constexpr std::size_t MAX_SPARE_WORDS = STORAGE_ALIGNMENT / sizeof(word_type);
+
   bitset(std::size_t size);
+  static std::size_t word_count(std::size_t size);
   static word_type* allocate_memory(std::size_t size);
+  bool can_hold(std::size_t size) const;
+
+  // Evaluation only ever reads words at or after the one being written, so
+  // the result may overwrite a buffer the expression itself reads from.
+  template <typename Expression>
+  void assign_expression(Expression&& expression) {
+    std::size_t size = expression.size();
+    if constexpr (!std::is_lvalue_reference_v<Expression>) {
+      bitset* storage = expression.template storage<bitset>();
+      if (storage != nullptr && storage->can_hold(size)) {
+        expression.evaluate(storage->words);
+        storage->bit_count = size;
+        *this = std::move(*storage);
+        return;
+      }
+    }
+    if (can_hold(size)) {
+      expression.evaluate(words);
+      bit_count = size;
+      return;
+    }
+    bitset result(size);
+    expression.evaluate(result.words);
+    swap(result);
+  }
 };
 
 bool operator==(const bitset& left, const bitset& right);
 bool operator!=(const bitset& left, const bitset& right);
 
-bitset operator&(const bitset& lhs, const bitset& rhs);
-bitset operator|(const bitset& lhs, const bitset& rhs);
-bitset operator^(const bitset& lhs, const bitset& rhs);
-
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator~(const bitset::const_view& bs);
-
-bitset operator~(const bitset& bs);
 bitset operator<<(const bitset& bs, std::size_t count);
 bitset operator>>(const bitset& bs, std::size_t count);
+bitset operator<<(bitset&& bs, std::size_t count);
+bitset operator>>(bitset&& bs, std::size_t count);
 bitset operator<<(const bitset::const_view& bs_v, std::size_t count);
 bitset operator>>(const bitset::const_view& bs_v, std::size_t count);
 
 void swap(bitset& lhs, bitset& rhs) noexcept;
 
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t or_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t xor_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t andnot_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+bool intersects(const bitset::const_view& lhs, const bitset::const_view& rhs);
+bool is_subset_of(const bitset::const_view& lhs, const bitset::const_view& rhs);
+
+// dst = Function(a, b, c) bit by bit; see TERNARY_A for building `Function`.
+template <uint8_t Function>
+void ternary(const bitset::view& dst, const bitset::const_view& a, const bitset::const_view& b, const bitset::const_view& c) {
+  dst.ternary<Function>(a, b, c);
+}
+
+std::size_t to_indices(const bitset::const_view& bs, uint32_t* out);
+std::size_t to_indices(const bitset::const_view& bs, uint64_t* out);
+std::vector<uint32_t> to_indices(const bitset::const_view& bs);
+std::vector<uint64_t> to_indices64(const bitset::const_view& bs);
+
 std::string to_string(const bitset& bs);
 std::ostream& operator<<(std::ostream& out, const bitset& bs);
@@ -0,0 +1,665 @@
+#include "compressed-bitset.h"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+
+std::size_t compressed_bitset::container::count() const {
+  switch (kind) {
+  case container_kind::array:
+    return values.size();
+  case container_kind::bitmap:
+    return cardinality;
+  case container_kind::run: {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+      result += values[i + 1] - values[i] + 1;
+    }
+    return result;
+  }
+  }
+  return 0;
+}
+
+bool compressed_bitset::container::empty() const {
+  return kind == container_kind::bitmap ? cardinality == 0 : values.empty();
+}
+
+bool compressed_bitset::container::contains(uint16_t value) const {
+  switch (kind) {
+  case container_kind::array:
+    return std::binary_search(values.begin(), values.end(), value);
+  case container_kind::bitmap:
+    return bits[value];
+  case container_kind::run: {
+    std::size_t run = find_run(value);
+    return run < values.size() && values[run] <= value;
+  }
+  }
+  return false;
+}
+
+std::size_t compressed_bitset::container::next(std::size_t value) const {
+  if (value >= CHUNK_BITS) {
+    return CHUNK_BITS;
+  }
+  switch (kind) {
+  case container_kind::array: {
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+    return it == values.end() ? CHUNK_BITS : *it;
+  }
+  case container_kind::bitmap: {
+    std::size_t pos = bits.subview(value).find_first();
+    return pos == bitset::npos ? CHUNK_BITS : value + pos;
+  }
+  case container_kind::run: {
+    std::size_t run = find_run(value);
+    return run < values.size() ? std::max<std::size_t>(values[run], value) : CHUNK_BITS;
+  }
+  }
+  return CHUNK_BITS;
+}
+
+std::size_t compressed_bitset::container::find_run(std::size_t value) const {
+  auto runs = std::views::iota(std::size_t(0), values.size() / 2);
+  auto it = std::ranges::lower_bound(runs, value, {}, [&](std::size_t run) { return values[2 * run + 1]; });
+  return 2 * static_cast<std::size_t>(it - runs.begin());
+}
+
+bitset compressed_bitset::container::to_bitmap() const {
+  switch (kind) {
+  case container_kind::array: {
+    std::vector<uint32_t> indices(values.begin(), values.end());
+    return bitset::from_indices(CHUNK_BITS, indices);
+  }
+  case container_kind::bitmap:
+    return bits;
+  case container_kind::run: {
+    bitset result(CHUNK_BITS, false);
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+      result.subview(values[i], values[i + 1] - values[i] + 1).set();
+    }
+    return result;
+  }
+  }
+  return {};
+}
+
+std::vector<uint16_t> compressed_bitset::container::to_array() const {
+  switch (kind) {
+  case container_kind::array:
+    return values;
+  case container_kind::bitmap: {
+    std::vector<uint16_t> result;
+    result.reserve(bits.count());
+    for (std::size_t pos : bits.ones()) {
+      result.push_back(static_cast<uint16_t>(pos));
+    }
+    return result;
+  }
+  case container_kind::run: {
+    std::vector<uint16_t> result;
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+      for (std::size_t pos = values[i]; pos <= values[i + 1]; ++pos) {
+        result.push_back(static_cast<uint16_t>(pos));
+      }
+    }
+    return result;
+  }
+  }
+  return {};
+}
+
+std::vector<uint16_t> compressed_bitset::container::to_runs() const {
+  std::vector<uint16_t> result;
+  switch (kind) {
+  case container_kind::array:
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (i == 0 || values[i] != values[i - 1] + 1) {
+        if (i != 0) {
+          result.push_back(values[i - 1]);
+        }
+        result.push_back(values[i]);
+      }
+    }
+    if (!values.empty()) {
+      result.push_back(values.back());
+    }
+    return result;
+  case container_kind::bitmap:
+    for (std::size_t first = bits.find_first(); first != bitset::npos;) {
+      std::size_t end = bits.find_next_zero(first);
+      std::size_t last = (end == bitset::npos ? CHUNK_BITS : end) - 1;
+      result.push_back(static_cast<uint16_t>(first));
+      result.push_back(static_cast<uint16_t>(last));
+      first = bits.find_next(last);
+    }
+    return result;
+  case container_kind::run:
+    return values;
+  }
+  return result;
+}
+
+void compressed_bitset::container::optimize() {
+  std::size_t ones = count();
+  std::vector<uint16_t> runs = to_runs();
+  std::size_t run_bytes = runs.size() * sizeof(uint16_t);
+  std::size_t array_bytes = ones * sizeof(uint16_t);
+  std::size_t bitmap_bytes = CHUNK_BITS / 8;
+  if (run_bytes < std::min(array_bytes, bitmap_bytes)) {
+    values = std::move(runs);
+    bits = bitset();
+    cardinality = 0;
+    kind = container_kind::run;
+  } else if (ones <= MAX_ARRAY_SIZE) {
+    convert(container_kind::array);
+  } else if (kind != container_kind::bitmap) {
+    convert(container_kind::bitmap);
+  }
+}
+
+void compressed_bitset::container::convert(container_kind target) {
+  switch (target) {
+  case container_kind::array:
+    values = to_array();
+    bits = bitset();
+    cardinality = 0;
+    break;
+  case container_kind::bitmap:
+    cardinality = count();
+    bits = to_bitmap();
+    values.clear();
+    values.shrink_to_fit();
+    break;
+  case container_kind::run:
+    values = to_runs();
+    bits = bitset();
+    cardinality = 0;
+    break;
+  }
+  kind = target;
+}
+
+void compressed_bitset::container::insert(uint16_t value) {
+  switch (kind) {
+  case container_kind::array: {
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+    if (it == values.end() || *it != value) {
+      values.insert(it, value);
+      if (values.size() > MAX_ARRAY_SIZE) {
+        convert(container_kind::bitmap);
+      }
+    }
+    break;
+  }
+  case container_kind::bitmap:
+    if (!bits[value]) {
+      bits[value] = true;
+      ++cardinality;
+    }
+    break;
+  case container_kind::run: {
+    std::size_t run = find_run(value);
+    if (run < values.size() && values[run] <= value) {
+      break;
+    }
+    bool extends_previous = run != 0 && values[run - 1] + 1 == value;
+    bool extends_next = run < values.size() && values[run] == value + 1;
+    if (extends_previous && extends_next) {
+      values[run - 1] = values[run + 1];
+      values.erase(values.begin() + run, values.begin() + run + 2);
+    } else if (extends_previous) {
+      values[run - 1] = value;
+    } else if (extends_next) {
+      values[run] = value;
+    } else {
+      values.insert(values.begin() + run, {value, value});
+      if (values.size() * sizeof(uint16_t) > CHUNK_BITS / 8) {
+        convert(container_kind::bitmap);
+      }
+    }
+    break;
+  }
+  }
+}
+
+void compressed_bitset::container::erase(uint16_t value) {
+  switch (kind) {
+  case container_kind::array: {
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+    if (it != values.end() && *it == value) {
+      values.erase(it);
+    }
+    break;
+  }
+  case container_kind::bitmap:
+    if (bits[value]) {
+      bits[value] = false;
+      // Half the limit, so that alternating set/reset at the limit does not
+      // convert back and forth.
+      if (--cardinality <= MAX_ARRAY_SIZE / 2) {
+        convert(container_kind::array);
+      }
+    }
+    break;
+  case container_kind::run: {
+    std::size_t run = find_run(value);
+    if (run == values.size() || values[run] > value) {
+      break;
+    }
+    if (values[run] == values[run + 1]) {
+      values.erase(values.begin() + run, values.begin() + run + 2);
+    } else if (values[run] == value) {
+      ++values[run];
+    } else if (values[run + 1] == value) {
+      --values[run + 1];
+    } else {
+      values.insert(values.begin() + run + 1, {static_cast<uint16_t>(value - 1), static_cast<uint16_t>(value + 1)});
+      if (values.size() * sizeof(uint16_t) > CHUNK_BITS / 8) {
+        convert(container_kind::bitmap);
+      }
+    }
+    break;
+  }
+  }
+}
+
+bool compressed_bitset::container::operator==(const container& other) const {
+  if (key != other.key || count() != other.count()) {
+    return false;
+  }
+  if (kind == other.kind) {
+    return kind == container_kind::bitmap ? bits == other.bits : values == other.values;
+  }
+  if (kind != container_kind::bitmap && other.kind != container_kind::bitmap) {
+    return to_array() == other.to_array();
+  }
+  return to_bitmap() == other.to_bitmap();
+}
+
+compressed_bitset::compressed_bitset() = default;
+
+compressed_bitset::compressed_bitset(std::size_t size)
+    : _size(size) {}
+
+compressed_bitset::compressed_bitset(const bitset::const_view& bits)
+    : _size(bits.size()) {
+  for (std::size_t key = 0; key * CHUNK_BITS < _size; ++key) {
+    container chunk = chunk_from_view(bits, key);
+    if (chunk.kind != container_kind::array || !chunk.values.empty()) {
+      _containers.push_back(std::move(chunk));
+    }
+  }
+}
+
+compressed_bitset::container compressed_bitset::chunk_from_view(const bitset::const_view& bits, std::size_t key) const {
+  container result;
+  result.key = key;
+  bitset::const_view chunk = bits.subview(key * CHUNK_BITS, CHUNK_BITS);
+  if (!chunk.any()) {
+    return result;
+  }
+  result.kind = container_kind::bitmap;
+  result.bits = bitset(CHUNK_BITS, false);
+  result.bits.subview(0, chunk.size()).assign(chunk);
+  result.cardinality = chunk.count();
+  result.optimize();
+  return result;
+}
+
+std::size_t compressed_bitset::size() const {
+  return _size;
+}
+
+bool compressed_bitset::empty() const {
+  return _size == 0;
+}
+
+std::size_t compressed_bitset::count() const {
+  std::size_t result = 0;
+  for (const container& c : _containers) {
+    result += c.count();
+  }
+  return result;
+}
+
+bool compressed_bitset::any() const {
+  return !_containers.empty();
+}
+
+std::vector<compressed_bitset::container>::iterator compressed_bitset::container_position(std::size_t key) {
+  return std::lower_bound(_containers.begin(), _containers.end(), key, [](const container& c, std::size_t k) {
+    return c.key < k;
+  });
+}
+
+compressed_bitset::container* compressed_bitset::find_container(std::size_t key) {
+  auto it = container_position(key);
+  return (it != _containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+const compressed_bitset::container* compressed_bitset::find_container(std::size_t key) const {
+  return const_cast<compressed_bitset*>(this)->find_container(key);
+}
+
+bool compressed_bitset::test(std::size_t pos) const {
+  const container* c = find_container(pos / CHUNK_BITS);
+  return c != nullptr && c->contains(static_cast<uint16_t>(pos % CHUNK_BITS));
+}
+
+void compressed_bitset::set(std::size_t pos) {
+  if (pos >= _size) {
+    throw std::out_of_range("compressed_bitset::set: position out of range");
+  }
+  std::size_t key = pos / CHUNK_BITS;
+  auto it = container_position(key);
+  if (it == _containers.end() || it->key != key) {
+    it = _containers.insert(it, container());
+    it->key = key;
+  }
+  it->insert(static_cast<uint16_t>(pos % CHUNK_BITS));
+}
+
+void compressed_bitset::reset(std::size_t pos) {
+  if (pos >= _size) {
+    throw std::out_of_range("compressed_bitset::reset: position out of range");
+  }
+  std::size_t key = pos / CHUNK_BITS;
+  auto it = container_position(key);
+  if (it != _containers.end() && it->key == key) {
+    it->erase(static_cast<uint16_t>(pos % CHUNK_BITS));
+    if (it->empty()) {
+      _containers.erase(it);
+    }
+  }
+}
+
+bitset compressed_bitset::to_bitset() const {
+  bitset result(_size, false);
+  for (const container& c : _containers) {
+    std::size_t base = c.key * CHUNK_BITS;
+    bitset::view target = result.subview(base, CHUNK_BITS);
+    switch (c.kind) {
+    case container_kind::array: {
+      std::vector<uint32_t> indices(c.values.begin(), c.values.end());
+      target.set_many(indices);
+      break;
+    }
+    case container_kind::bitmap:
+      target.assign(c.bits.subview(0, target.size()));
+      break;
+    case container_kind::run:
+      for (std::size_t i = 0; i < c.values.size(); i += 2) {
+        target.subview(c.values[i], c.values[i + 1] - c.values[i] + 1).set();
+      }
+      break;
+    }
+  }
+  return result;
+}
+
+compressed_bitset::container compressed_bitset::combine(const container& lhs, const container& rhs, operation op) {
+  container result;
+  result.key = lhs.key;
+  if (lhs.kind == container_kind::array && rhs.kind == container_kind::array) {
+    auto out = std::back_inserter(result.values);
+    auto l_begin = lhs.values.begin();
+    auto l_end = lhs.values.end();
+    auto r_begin = rhs.values.begin();
+    auto r_end = rhs.values.end();
+    switch (op) {
+    case operation::bit_and:
+      std::set_intersection(l_begin, l_end, r_begin, r_end, out);
+      break;
+    case operation::bit_or:
+      std::set_union(l_begin, l_end, r_begin, r_end, out);
+      break;
+    case operation::bit_xor:
+      std::set_symmetric_difference(l_begin, l_end, r_begin, r_end, out);
+      break;
+    case operation::bit_andnot:
+      std::set_difference(l_begin, l_end, r_begin, r_end, out);
+      break;
+    }
+  } else if (op == operation::bit_and && (lhs.kind == container_kind::array || rhs.kind == container_kind::array)) {
+    const container& array = (lhs.kind == container_kind::array) ? lhs : rhs;
+    const container& other = (lhs.kind == container_kind::array) ? rhs : lhs;
+    std::copy_if(array.values.begin(), array.values.end(), std::back_inserter(result.values), [&](uint16_t value) {
+      return other.contains(value);
+    });
+  } else if (op == operation::bit_andnot && lhs.kind == container_kind::array) {
+    std::copy_if(lhs.values.begin(), lhs.values.end(), std::back_inserter(result.values), [&](uint16_t value) {
+      return !rhs.contains(value);
+    });
+  } else {
+    result.kind = container_kind::bitmap;
+    result.bits = lhs.to_bitmap();
+    bitset other = rhs.to_bitmap();
+    switch (op) {
+    case operation::bit_and:
+      result.bits &= other;
+      break;
+    case operation::bit_or:
+      result.bits |= other;
+      break;
+    case operation::bit_xor:
+      result.bits ^= other;
+      break;
+    case operation::bit_andnot:
+      other.flip();
+      result.bits &= other;
+      break;
+    }
+    result.cardinality = result.bits.count();
+  }
+  result.optimize();
+  return result;
+}
+
+compressed_bitset& compressed_bitset::apply(const compressed_bitset& other, operation op) {
+  std::vector<container> result;
+  auto lhs = _containers.begin();
+  auto rhs = other._containers.begin();
+  bool keep_lhs_only = (op != operation::bit_and);
+  bool keep_rhs_only = (op == operation::bit_or || op == operation::bit_xor);
+  while (lhs != _containers.end() || rhs != other._containers.end()) {
+    if (rhs == other._containers.end() || (lhs != _containers.end() && lhs->key < rhs->key)) {
+      if (keep_lhs_only) {
+        result.push_back(std::move(*lhs));
+      }
+      ++lhs;
+    } else if (lhs == _containers.end() || rhs->key < lhs->key) {
+      if (keep_rhs_only) {
+        result.push_back(*rhs);
+      }
+      ++rhs;
+    } else {
+      container combined = combine(*lhs, *rhs, op);
+      if (combined.kind != container_kind::array || !combined.values.empty()) {
+        result.push_back(std::move(combined));
+      }
+      ++lhs;
+      ++rhs;
+    }
+  }
+  _containers = std::move(result);
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::apply_with_view(const bitset::const_view& other, operation op) {
+  if (op == operation::bit_and || op == operation::bit_andnot) {
+    std::vector<container> result;
+    for (container& c : _containers) {
+      container combined = combine(c, chunk_from_view(other, c.key), op);
+      if (combined.kind != container_kind::array || !combined.values.empty()) {
+        result.push_back(std::move(combined));
+      }
+    }
+    _containers = std::move(result);
+    return *this;
+  }
+  return apply(compressed_bitset(other), op);
+}
+
+compressed_bitset& compressed_bitset::operator&=(const compressed_bitset& other) & {
+  return apply(other, operation::bit_and);
+}
+
+compressed_bitset& compressed_bitset::operator|=(const compressed_bitset& other) & {
+  return apply(other, operation::bit_or);
+}
+
+compressed_bitset& compressed_bitset::operator^=(const compressed_bitset& other) & {
+  return apply(other, operation::bit_xor);
+}
+
+compressed_bitset& compressed_bitset::andnot(const compressed_bitset& other) & {
+  return apply(other, operation::bit_andnot);
+}
+
+compressed_bitset& compressed_bitset::operator&=(const bitset::const_view& other) & {
+  return apply_with_view(other, operation::bit_and);
+}
+
+compressed_bitset& compressed_bitset::operator|=(const bitset::const_view& other) & {
+  return apply_with_view(other, operation::bit_or);
+}
+
+compressed_bitset& compressed_bitset::operator^=(const bitset::const_view& other) & {
+  return apply_with_view(other, operation::bit_xor);
+}
+
+compressed_bitset& compressed_bitset::andnot(const bitset::const_view& other) & {
+  return apply_with_view(other, operation::bit_andnot);
+}
+
+compressed_bitset::const_iterator compressed_bitset::begin() const {
+  return {&_containers, 0};
+}
+
+compressed_bitset::const_iterator compressed_bitset::end() const {
+  return {&_containers, _containers.size()};
+}
+
+compressed_bitset::const_iterator::const_iterator(const std::vector<container>* containers, std::size_t container)
+    : _containers(containers)
+    , _container(container) {
+  settle();
+}
+
+void compressed_bitset::const_iterator::settle() {
+  if (_container == _containers->size()) {
+    _state = 0;
+    return;
+  }
+  const compressed_bitset::container& c = (*_containers)[_container];
+  if (c.kind == container_kind::bitmap) {
+    _state = c.next(_state);
+  } else if (c.kind == container_kind::run) {
+    while (_run < c.values.size() && c.values[_run + 1] < _state) {
+      _run += 2;
+    }
+    _state = _run < c.values.size() ? std::max<std::size_t>(c.values[_run], _state) : CHUNK_BITS;
+  }
+  bool exhausted = (c.kind == container_kind::array) ? _state >= c.values.size() : _state >= CHUNK_BITS;
+  if (exhausted) {
+    ++_container;
+    _state = 0;
+    _run = 0;
+    settle();
+  }
+}
+
+std::size_t compressed_bitset::const_iterator::operator*() const {
+  const compressed_bitset::container& c = (*_containers)[_container];
+  std::size_t value = (c.kind == container_kind::array) ? c.values[_state] : _state;
+  return c.key * CHUNK_BITS + value;
+}
+
+compressed_bitset::const_iterator& compressed_bitset::const_iterator::operator++() {
+  ++_state;
+  settle();
+  return *this;
+}
+
+compressed_bitset::const_iterator compressed_bitset::const_iterator::operator++(int) {
+  const_iterator tmp = *this;
+  ++(*this);
+  return tmp;
+}
+
+bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  return lhs._size == rhs._size && lhs._containers == rhs._containers;
+}
+
+bool operator!=(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  return !(lhs == rhs);
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result = lhs;
+  result &= rhs;
+  return result;
+}
+
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result = lhs;
+  result |= rhs;
+  return result;
+}
+
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result = lhs;
+  result ^= rhs;
+  return result;
+}
+
+compressed_bitset andnot(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result = lhs;
+  result.andnot(rhs);
+  return result;
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const bitset::const_view& rhs) {
+  compressed_bitset result = lhs;
+  result &= rhs;
+  return result;
+}
+
+compressed_bitset operator|(const compressed_bitset& lhs, const bitset::const_view& rhs) {
+  compressed_bitset result = lhs;
+  result |= rhs;
+  return result;
+}
+
+compressed_bitset operator^(const compressed_bitset& lhs, const bitset::const_view& rhs) {
+  compressed_bitset result = lhs;
+  result ^= rhs;
+  return result;
+}
+
+compressed_bitset andnot(const compressed_bitset& lhs, const bitset::const_view& rhs) {
+  compressed_bitset result = lhs;
+  result.andnot(rhs);
+  return result;
+}
+
+compressed_bitset operator&(const bitset::const_view& lhs, const compressed_bitset& rhs) {
+  return rhs & lhs;
+}
+
+compressed_bitset operator|(const bitset::const_view& lhs, const compressed_bitset& rhs) {
+  return rhs | lhs;
+}
+
+compressed_bitset operator^(const bitset::const_view& lhs, const compressed_bitset& rhs) {
+  return rhs ^ lhs;
+}
+
+compressed_bitset andnot(const bitset::const_view& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result(lhs);
+  result.andnot(rhs);
+  return result;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Roaring-style compressed bitset. The bit range is split into chunks of 2^16
+// bits and only non-empty chunks are stored, each as a sorted array of
+// positions, a plain 2^16-bit bitmap or a list of runs. Bulk operations pick
+// the cheapest of the three; set() and reset() edit a chunk in place and only
+// change its kind when an array or run list outgrows a bitmap, or a bitmap
+// drops to half the array limit.
+class compressed_bitset {
+public:
+  static constexpr std::size_t CHUNK_BITS = 1 << 16;
+  static constexpr std::size_t MAX_ARRAY_SIZE = 4096;
+
+  class const_iterator;
+
+  compressed_bitset();
+  explicit compressed_bitset(std::size_t size);
+  explicit compressed_bitset(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  std::size_t count() const;
+  bool any() const;
+  bool test(std::size_t pos) const;
+
+  // Both throw std::out_of_range if `pos >= size()`.
+  void set(std::size_t pos);
+  void reset(std::size_t pos);
+
+  bitset to_bitset() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  compressed_bitset& operator&=(const compressed_bitset& other) &;
+  compressed_bitset& operator|=(const compressed_bitset& other) &;
+  compressed_bitset& operator^=(const compressed_bitset& other) &;
+  compressed_bitset& andnot(const compressed_bitset& other) &;
+
+  compressed_bitset& operator&=(const bitset::const_view& other) &;
+  compressed_bitset& operator|=(const bitset::const_view& other) &;
+  compressed_bitset& operator^=(const bitset::const_view& other) &;
+  compressed_bitset& andnot(const bitset::const_view& other) &;
+
+  friend bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+private:
+  enum class container_kind {
+    array,
+    bitmap,
+    run,
+  };
+
+  enum class operation {
+    bit_and,
+    bit_or,
+    bit_xor,
+    bit_andnot,
+  };
+
+  struct container {
+    std::size_t key = 0;
+    container_kind kind = container_kind::array;
+    // Sorted positions for arrays, inclusive (first, last) pairs for runs.
+    std::vector<uint16_t> values;
+    bitset bits;
+    // Number of ones in `bits`; unused for the other kinds.
+    std::size_t cardinality = 0;
+
+    std::size_t count() const;
+    bool empty() const;
+    bool contains(uint16_t value) const;
+    // Smallest stored position >= value, or CHUNK_BITS.
+    std::size_t next(std::size_t value) const;
+    // Index in `values` of the first run ending at or after `value`.
+    std::size_t find_run(std::size_t value) const;
+
+    bitset to_bitmap() const;
+    std::vector<uint16_t> to_array() const;
+    std::vector<uint16_t> to_runs() const;
+    void optimize();
+    void convert(container_kind target);
+
+    void insert(uint16_t value);
+    void erase(uint16_t value);
+
+    // Compares the stored positions, whatever the kinds.
+    bool operator==(const container& other) const;
+  };
+
+  std::size_t _size = 0;
+  std::vector<container> _containers;
+
+  std::vector<container>::iterator container_position(std::size_t key);
+  container* find_container(std::size_t key);
+  const container* find_container(std::size_t key) const;
+  container chunk_from_view(const bitset::const_view& bits, std::size_t key) const;
+
+  static container combine(const container& lhs, const container& rhs, operation op);
+  compressed_bitset& apply(const compressed_bitset& other, operation op);
+  compressed_bitset& apply_with_view(const bitset::const_view& other, operation op);
+
+public:
+  class const_iterator {
+    friend class compressed_bitset;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::size_t;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    std::size_t operator*() const;
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs._container == rhs._container && lhs._state == rhs._state;
+    }
+
+  private:
+    const std::vector<container>* _containers = nullptr;
+    std::size_t _container = 0;
+    // Index into `values` for arrays, current position otherwise.
+    std::size_t _state = 0;
+    // Index into `values` of the run holding or following `_state`.
+    std::size_t _run = 0;
+
+    const_iterator(const std::vector<container>* containers, std::size_t container);
+
+    void settle();
+  };
+};
+
+bool operator!=(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset andnot(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+compressed_bitset operator&(const compressed_bitset& lhs, const bitset::const_view& rhs);
+compressed_bitset operator|(const compressed_bitset& lhs, const bitset::const_view& rhs);
+compressed_bitset operator^(const compressed_bitset& lhs, const bitset::const_view& rhs);
+compressed_bitset andnot(const compressed_bitset& lhs, const bitset::const_view& rhs);
+
+compressed_bitset operator&(const bitset::const_view& lhs, const compressed_bitset& rhs);
+compressed_bitset operator|(const bitset::const_view& lhs, const compressed_bitset& rhs);
+compressed_bitset operator^(const bitset::const_view& lhs, const compressed_bitset& rhs);
+compressed_bitset andnot(const bitset::const_view& lhs, const compressed_bitset& rhs);
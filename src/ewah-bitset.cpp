@@ -0,0 +1,324 @@
+#include "ewah-bitset.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace {
+
+using word_type = ewah_bitset::word_type;
+
+constexpr word_type ALL_ONES = ~word_type(0);
+constexpr std::size_t RUN_SHIFT = 1;
+constexpr std::size_t LITERAL_SHIFT = 33;
+
+bool marker_bit(word_type marker) {
+  return (marker & 1) != 0;
+}
+
+std::size_t marker_run_length(word_type marker) {
+  return (marker >> RUN_SHIFT) & ewah_bitset::MAX_RUN_LENGTH;
+}
+
+std::size_t marker_literal_count(word_type marker) {
+  return marker >> LITERAL_SHIFT;
+}
+
+word_type make_marker(bool bit, std::size_t run_length, std::size_t literal_count) {
+  return word_type(bit) | (word_type(run_length) << RUN_SHIFT) | (word_type(literal_count) << LITERAL_SHIFT);
+}
+
+} // namespace
+
+// Appends fills and literals to a stream, merging them into the current
+// marker where possible so that equal bitsets always encode identically.
+class ewah_bitset::builder {
+public:
+  explicit builder(std::vector<word_type>& buffer)
+      : _buffer(buffer) {
+    _buffer.clear();
+    start_marker();
+  }
+
+  void add_fill(bool bit, std::size_t count) {
+    while (count > 0) {
+      word_type marker = _buffer[_marker];
+      std::size_t run_length = marker_run_length(marker);
+      if (marker_literal_count(marker) != 0 || (run_length != 0 && marker_bit(marker) != bit) ||
+          run_length == MAX_RUN_LENGTH) {
+        start_marker();
+        continue;
+      }
+      std::size_t added = std::min(count, MAX_RUN_LENGTH - run_length);
+      _buffer[_marker] = make_marker(bit, run_length + added, 0);
+      count -= added;
+    }
+  }
+
+  void add_literal(word_type word) {
+    if (word == 0 || word == ALL_ONES) {
+      add_fill(word != 0, 1);
+      return;
+    }
+    if (marker_literal_count(_buffer[_marker]) == MAX_LITERAL_COUNT) {
+      start_marker();
+    }
+    _buffer[_marker] += word_type(1) << LITERAL_SHIFT;
+    _buffer.push_back(word);
+  }
+
+private:
+  std::vector<word_type>& _buffer;
+  std::size_t _marker = 0;
+
+  void start_marker() {
+    _marker = _buffer.size();
+    _buffer.push_back(0);
+  }
+};
+
+// Walks a stream one marker at a time. At any point the reader is either
+// inside a fill (run_length() != 0) or in front of literal_count() literals.
+class ewah_bitset::reader {
+public:
+  explicit reader(const std::vector<word_type>& buffer)
+      : _buffer(buffer) {
+    normalize();
+  }
+
+  bool done() const {
+    return _run_length == 0 && _literal_count == 0;
+  }
+
+  bool run_bit() const {
+    return _run_bit;
+  }
+
+  std::size_t run_length() const {
+    return _run_length;
+  }
+
+  std::size_t literal_count() const {
+    return _literal_count;
+  }
+
+  const word_type* literals() const {
+    return _buffer.data() + _position;
+  }
+
+  void skip_run(std::size_t count) {
+    _run_length -= count;
+    normalize();
+  }
+
+  void skip_literals(std::size_t count) {
+    _position += count;
+    _literal_count -= count;
+    normalize();
+  }
+
+private:
+  const std::vector<word_type>& _buffer;
+  std::size_t _position = 0;
+  bool _run_bit = false;
+  std::size_t _run_length = 0;
+  std::size_t _literal_count = 0;
+
+  void normalize() {
+    while (done() && _position < _buffer.size()) {
+      word_type marker = _buffer[_position++];
+      _run_bit = marker_bit(marker);
+      _run_length = marker_run_length(marker);
+      _literal_count = marker_literal_count(marker);
+    }
+  }
+};
+
+ewah_bitset::ewah_bitset()
+    : _buffer(1, 0) {}
+
+ewah_bitset::ewah_bitset(std::size_t size)
+    : _size(size) {
+  builder out(_buffer);
+  out.add_fill(false, (size + BITS_PER_WORD - 1) / BITS_PER_WORD);
+}
+
+ewah_bitset::ewah_bitset(const bitset::const_view& bits)
+    : _size(bits.size()) {
+  builder out(_buffer);
+  std::size_t pos = 0;
+  while (pos < _size) {
+    std::size_t n = std::min(BITS_PER_WORD, _size - pos);
+    word_type word = (bits.begin() + static_cast<std::ptrdiff_t>(pos)).get_n_bits(n);
+    if (n == BITS_PER_WORD && (word == 0 || word == ALL_ONES)) {
+      // Jump straight to the end of the run instead of loading every word.
+      bool bit = word != 0;
+      std::size_t end = bit ? bits.find_next_zero(pos) : bits.find_next(pos);
+      std::size_t words = ((end == bitset::npos ? _size : end) - pos) / BITS_PER_WORD;
+      out.add_fill(bit, words);
+      pos += words * BITS_PER_WORD;
+    } else {
+      out.add_literal(word);
+      pos += n;
+    }
+  }
+}
+
+std::size_t ewah_bitset::size() const {
+  return _size;
+}
+
+bool ewah_bitset::empty() const {
+  return _size == 0;
+}
+
+std::size_t ewah_bitset::count() const {
+  std::size_t result = 0;
+  for (reader in(_buffer); !in.done();) {
+    if (in.run_length() != 0) {
+      result += in.run_bit() ? in.run_length() * BITS_PER_WORD : 0;
+      in.skip_run(in.run_length());
+    } else {
+      const word_type* literals = in.literals();
+      for (std::size_t i = 0; i < in.literal_count(); ++i) {
+        result += std::popcount(literals[i]);
+      }
+      in.skip_literals(in.literal_count());
+    }
+  }
+  return result;
+}
+
+bool ewah_bitset::any() const {
+  for (reader in(_buffer); !in.done();) {
+    if (in.run_length() == 0 || in.run_bit()) {
+      return true;
+    }
+    in.skip_run(in.run_length());
+  }
+  return false;
+}
+
+std::size_t ewah_bitset::buffer_size() const {
+  return _buffer.size();
+}
+
+void ewah_bitset::decode(const bitset::view& out) const {
+  std::size_t pos = 0;
+  for (reader in(_buffer); !in.done();) {
+    if (in.run_length() != 0) {
+      std::size_t bits = std::min(in.run_length() * BITS_PER_WORD, _size - pos);
+      bitset::view run = out.subview(pos, bits);
+      if (in.run_bit()) {
+        run.set();
+      } else {
+        run.reset();
+      }
+      pos += bits;
+      in.skip_run(in.run_length());
+    } else {
+      const word_type* literals = in.literals();
+      for (std::size_t i = 0; i < in.literal_count(); ++i) {
+        std::size_t n = std::min(BITS_PER_WORD, _size - pos);
+        (out.begin() + static_cast<std::ptrdiff_t>(pos)).change_n_bits(literals[i], n);
+        pos += n;
+      }
+      in.skip_literals(in.literal_count());
+    }
+  }
+}
+
+bitset ewah_bitset::to_bitset() const {
+  bitset result(_size, false);
+  decode(result);
+  return result;
+}
+
+template <typename Operation>
+ewah_bitset ewah_bitset::combine(const ewah_bitset& lhs, const ewah_bitset& rhs, Operation op) {
+  ewah_bitset result;
+  result._size = lhs._size;
+  builder out(result._buffer);
+  reader left(lhs._buffer);
+  reader right(rhs._buffer);
+  while (!left.done() && !right.done()) {
+    if (left.run_length() != 0 && right.run_length() != 0) {
+      std::size_t n = std::min(left.run_length(), right.run_length());
+      word_type word = op(left.run_bit() ? ALL_ONES : 0, right.run_bit() ? ALL_ONES : 0);
+      out.add_fill(word != 0, n);
+      left.skip_run(n);
+      right.skip_run(n);
+    } else if (left.run_length() != 0 || right.run_length() != 0) {
+      bool left_is_run = left.run_length() != 0;
+      reader& run = left_is_run ? left : right;
+      reader& literal = left_is_run ? right : left;
+      std::size_t n = std::min(run.run_length(), literal.literal_count());
+      word_type fill = run.run_bit() ? ALL_ONES : 0;
+      auto apply = [&](word_type word) {
+        return left_is_run ? op(fill, word) : op(word, fill);
+      };
+      // AND with zeros and OR with ones do not depend on the literals.
+      if (apply(0) == apply(ALL_ONES)) {
+        out.add_fill(apply(0) != 0, n);
+      } else {
+        const word_type* literals = literal.literals();
+        for (std::size_t i = 0; i < n; ++i) {
+          out.add_literal(apply(literals[i]));
+        }
+      }
+      run.skip_run(n);
+      literal.skip_literals(n);
+    } else {
+      std::size_t n = std::min(left.literal_count(), right.literal_count());
+      const word_type* left_literals = left.literals();
+      const word_type* right_literals = right.literals();
+      for (std::size_t i = 0; i < n; ++i) {
+        out.add_literal(op(left_literals[i], right_literals[i]));
+      }
+      left.skip_literals(n);
+      right.skip_literals(n);
+    }
+  }
+  return result;
+}
+
+ewah_bitset& ewah_bitset::operator&=(const ewah_bitset& other) & {
+  *this = combine(*this, other, std::bit_and<word_type>());
+  return *this;
+}
+
+ewah_bitset& ewah_bitset::operator|=(const ewah_bitset& other) & {
+  *this = combine(*this, other, std::bit_or<word_type>());
+  return *this;
+}
+
+ewah_bitset& ewah_bitset::operator^=(const ewah_bitset& other) & {
+  *this = combine(*this, other, std::bit_xor<word_type>());
+  return *this;
+}
+
+bool operator==(const ewah_bitset& lhs, const ewah_bitset& rhs) {
+  return lhs._size == rhs._size && lhs._buffer == rhs._buffer;
+}
+
+bool operator!=(const ewah_bitset& lhs, const ewah_bitset& rhs) {
+  return !(lhs == rhs);
+}
+
+ewah_bitset operator&(const ewah_bitset& lhs, const ewah_bitset& rhs) {
+  ewah_bitset result = lhs;
+  result &= rhs;
+  return result;
+}
+
+ewah_bitset operator|(const ewah_bitset& lhs, const ewah_bitset& rhs) {
+  ewah_bitset result = lhs;
+  result |= rhs;
+  return result;
+}
+
+ewah_bitset operator^(const ewah_bitset& lhs, const ewah_bitset& rhs) {
+  ewah_bitset result = lhs;
+  result ^= rhs;
+  return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Word-aligned hybrid (EWAH) run-length encoded bitset. The stream is a
+// sequence of marker words, each followed by the literal words it announces.
+// A marker stores a fill bit, the number of 64-bit fill words of that bit
+// which come first and the number of literal words that follow it. Logical
+// operations and count() work on the stream directly.
+class ewah_bitset {
+public:
+  using word_type = bitset::word_type;
+
+  static constexpr std::size_t BITS_PER_WORD = bitset::BITS_PER_WORD;
+  static constexpr std::size_t MAX_RUN_LENGTH = (std::size_t(1) << 32) - 1;
+  static constexpr std::size_t MAX_LITERAL_COUNT = (std::size_t(1) << 31) - 1;
+
+  ewah_bitset();
+  explicit ewah_bitset(std::size_t size);
+  explicit ewah_bitset(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t count() const;
+  bool any() const;
+
+  // Number of words in the encoded stream.
+  std::size_t buffer_size() const;
+
+  // Writes the decoded bits into `out`, which must have the same size.
+  void decode(const bitset::view& out) const;
+  bitset to_bitset() const;
+
+  ewah_bitset& operator&=(const ewah_bitset& other) &;
+  ewah_bitset& operator|=(const ewah_bitset& other) &;
+  ewah_bitset& operator^=(const ewah_bitset& other) &;
+
+  friend bool operator==(const ewah_bitset& lhs, const ewah_bitset& rhs);
+
+private:
+  class builder;
+  class reader;
+
+  std::size_t _size = 0;
+  std::vector<word_type> _buffer;
+
+  template <typename Operation>
+  static ewah_bitset combine(const ewah_bitset& lhs, const ewah_bitset& rhs, Operation op);
+};
+
+bool operator!=(const ewah_bitset& lhs, const ewah_bitset& rhs);
+
+ewah_bitset operator&(const ewah_bitset& lhs, const ewah_bitset& rhs);
+ewah_bitset operator|(const ewah_bitset& lhs, const ewah_bitset& rhs);
+ewah_bitset operator^(const ewah_bitset& lhs, const ewah_bitset& rhs);
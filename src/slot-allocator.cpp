@@ -0,0 +1,94 @@
+#include "slot-allocator.h"
+
+#include <bit>
+#include <functional>
+#include <thread>
+
+namespace {
+
+// Word where the calling thread last found a free slot. Shared by all
+// allocators, for which it is only a starting point; fresh threads start at
+// scattered places.
+thread_local std::size_t search_cursor = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+} // namespace
+
+// Bits past the capacity are claimed up front, so they are never handed out.
+slot_allocator::slot_allocator(std::size_t capacity)
+    : _capacity(capacity)
+    , _slots((capacity + BITS_PER_WORD - 1) / BITS_PER_WORD * BITS_PER_WORD)
+    , _full(_slots.word_count()) {
+  if (std::size_t tail = capacity % BITS_PER_WORD; tail != 0) {
+    _slots.fetch_or(_slots.word_count() - 1, ~atomic_bitset::word_type(0) << tail, std::memory_order_relaxed);
+  }
+}
+
+std::size_t slot_allocator::capacity() const {
+  return _capacity;
+}
+
+std::size_t slot_allocator::in_use() const {
+  return _slots.count() - (_slots.size() - _capacity);
+}
+
+bool slot_allocator::is_acquired(std::size_t slot) const {
+  return _slots.test(slot);
+}
+
+std::size_t slot_allocator::acquire() {
+  std::size_t words = _slots.word_count();
+  if (words == 0) {
+    return npos;
+  }
+  std::size_t start = search_cursor % words;
+  for (std::size_t step = 0; step < words;) {
+    std::size_t index = (start + step) % words;
+    atomic_bitset::word_type full = _full.load_word(index / BITS_PER_WORD, std::memory_order_relaxed);
+    if (std::size_t skip = std::countr_one(full >> (index % BITS_PER_WORD)); skip != 0) {
+      step += skip;
+      continue;
+    }
+    std::size_t slot;
+    if (try_acquire_in_word(index, slot)) {
+      search_cursor = index;
+      return slot;
+    }
+    ++step;
+  }
+  return npos;
+}
+
+void slot_allocator::release(std::size_t slot) {
+  std::size_t index = slot / BITS_PER_WORD;
+  _slots.fetch_and(index, ~(atomic_bitset::word_type(1) << (slot % BITS_PER_WORD)));
+  if (_full.test(index)) {
+    _full.reset(index);
+  }
+}
+
+bool slot_allocator::try_acquire_in_word(std::size_t index, std::size_t& slot) {
+  atomic_bitset::word_type word = _slots.load_word(index, std::memory_order_relaxed);
+  while (~word != 0) {
+    atomic_bitset::word_type bit = ~word & (word + 1);
+    if (_slots.compare_exchange_word(index, word, word | bit, std::memory_order_acquire)) {
+      if (~(word | bit) == 0) {
+        mark_full(index);
+      }
+      slot = index * BITS_PER_WORD + std::countr_zero(bit);
+      return true;
+    }
+  }
+  mark_full(index);
+  return false;
+}
+
+// A release may free a slot between our observing the word full and setting
+// the summary bit. The release reads the summary bit after clearing the slot
+// and we read the word after setting the summary bit; with sequentially
+// consistent accesses on both sides at least one of us sees the other.
+void slot_allocator::mark_full(std::size_t index) {
+  _full.set(index);
+  if (~_slots.load_word(index) != 0) {
+    _full.reset(index);
+  }
+}
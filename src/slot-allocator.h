@@ -0,0 +1,38 @@
+#pragma once
+
+#include "atomic-bitset.h"
+
+#include <cstddef>
+
+// Lock-free allocator of indices in [0, capacity()). Claimed slots are ones in
+// an atomic_bitset and are taken with a compare-and-swap on the whole word.
+// A second bitset records which words were seen full, so a search skips 64
+// full words per summary word read. Each thread resumes its search where its
+// last allocation succeeded, which keeps threads on different words.
+class slot_allocator {
+public:
+  static constexpr std::size_t npos = bitset::npos;
+
+  explicit slot_allocator(std::size_t capacity);
+
+  std::size_t capacity() const;
+  // Number of claimed slots; only exact while no other thread is allocating.
+  std::size_t in_use() const;
+  bool is_acquired(std::size_t slot) const;
+
+  // Claims a free slot, or returns npos when every slot is taken.
+  std::size_t acquire();
+  // Returns a slot obtained from acquire().
+  void release(std::size_t slot);
+
+private:
+  static constexpr std::size_t BITS_PER_WORD = atomic_bitset::BITS_PER_WORD;
+
+  std::size_t _capacity;
+  atomic_bitset _slots;
+  // Bit i is set when word i of `_slots` has no free slot.
+  atomic_bitset _full;
+
+  bool try_acquire_in_word(std::size_t index, std::size_t& slot);
+  void mark_full(std::size_t index);
+};
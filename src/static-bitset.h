@@ -0,0 +1,276 @@
+#pragma once
+
+#include "bitset-iterator.h"
+#include "bitset-view.h"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
+
+// Bitset whose size is fixed at compile time. The words are stored inline and
+// every operation is constexpr, with loops over a constant number of words that
+// the compiler unrolls. Bits past N are always clear. It converts to views,
+// so a static_bitset<N> can be passed wherever bitset::const_view is taken.
+template <std::size_t N, typename Word = uint64_t>
+class static_bitset {
+  static_assert(std::unsigned_integral<Word>);
+
+public:
+  using word_type = Word;
+  using view = bitset_view<word_type>;
+  using const_view = bitset_view<const word_type>;
+
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t BITS_PER_WORD = std::numeric_limits<word_type>::digits;
+  static constexpr std::size_t WORD_COUNT = (N + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+  class const_iterator;
+
+  constexpr static_bitset() = default;
+
+  // Bit i is set when str[i] is '1'; characters past N are ignored.
+  constexpr explicit static_bitset(std::string_view str) {
+    for (std::size_t i = 0; i < str.size() && i < N; ++i) {
+      set(i, str[i] == '1');
+    }
+  }
+
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  static constexpr bool empty() {
+    return N == 0;
+  }
+
+  constexpr bool test(std::size_t pos) const {
+    return (_words[pos / BITS_PER_WORD] >> (pos % BITS_PER_WORD) & 1) != 0;
+  }
+
+  constexpr bool operator[](std::size_t pos) const {
+    return test(pos);
+  }
+
+  constexpr static_bitset& set(std::size_t pos, bool value = true) & {
+    return value ? update(pos, [](word_type& word, word_type bit) { word |= bit; })
+                 : update(pos, [](word_type& word, word_type bit) { word &= ~bit; });
+  }
+
+  constexpr static_bitset& reset(std::size_t pos) & {
+    return set(pos, false);
+  }
+
+  constexpr static_bitset& flip(std::size_t pos) & {
+    return update(pos, [](word_type& word, word_type bit) { word ^= bit; });
+  }
+
+  constexpr static_bitset& set() & {
+    _words.fill(ALL_ONES);
+    return clear_tail();
+  }
+
+  constexpr static_bitset& reset() & {
+    _words.fill(0);
+    return *this;
+  }
+
+  constexpr static_bitset& flip() & {
+    for (word_type& word : _words) {
+      word = ~word;
+    }
+    return clear_tail();
+  }
+
+  constexpr static_bitset& operator&=(const static_bitset& other) & {
+    for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+      _words[i] &= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator|=(const static_bitset& other) & {
+    for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+      _words[i] |= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator^=(const static_bitset& other) & {
+    for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+      _words[i] ^= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& andnot(const static_bitset& other) & {
+    for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+      _words[i] &= ~other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr std::size_t count() const {
+    std::size_t result = 0;
+    for (word_type word : _words) {
+      result += std::popcount(word);
+    }
+    return result;
+  }
+
+  constexpr bool any() const {
+    for (word_type word : _words) {
+      if (word != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr bool all() const {
+    for (std::size_t i = 0; i + 1 < WORD_COUNT; ++i) {
+      if (_words[i] != ALL_ONES) {
+        return false;
+      }
+    }
+    return WORD_COUNT == 0 || _words[WORD_COUNT - 1] == TAIL_MASK;
+  }
+
+  constexpr std::size_t find_first() const {
+    return find_forward(0);
+  }
+
+  constexpr std::size_t find_next(std::size_t pos) const {
+    return pos >= N ? npos : find_forward(pos + 1);
+  }
+
+  // Positions of the set bits in increasing order.
+  constexpr const_iterator begin() const {
+    return {this, find_first()};
+  }
+
+  constexpr const_iterator end() const {
+    return {this, npos};
+  }
+
+  constexpr const std::array<word_type, WORD_COUNT>& words() const {
+    return _words;
+  }
+
+  operator view() {
+    return {{_words.data(), 0}, {_words.data(), N}};
+  }
+
+  operator const_view() const {
+    return {{_words.data(), 0}, {_words.data(), N}};
+  }
+
+  view subview(std::size_t offset = 0, std::size_t count = npos) {
+    return view(*this).subview(offset, count);
+  }
+
+  const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return const_view(*this).subview(offset, count);
+  }
+
+  friend constexpr bool operator==(const static_bitset& lhs, const static_bitset& rhs) = default;
+
+  friend constexpr static_bitset operator&(static_bitset lhs, const static_bitset& rhs) {
+    return lhs &= rhs;
+  }
+
+  friend constexpr static_bitset operator|(static_bitset lhs, const static_bitset& rhs) {
+    return lhs |= rhs;
+  }
+
+  friend constexpr static_bitset operator^(static_bitset lhs, const static_bitset& rhs) {
+    return lhs ^= rhs;
+  }
+
+  friend constexpr static_bitset operator~(static_bitset bits) {
+    return bits.flip();
+  }
+
+  friend constexpr static_bitset andnot(static_bitset lhs, const static_bitset& rhs) {
+    return lhs.andnot(rhs);
+  }
+
+private:
+  static constexpr word_type ALL_ONES = std::numeric_limits<word_type>::max();
+  static constexpr word_type TAIL_MASK =
+      N % BITS_PER_WORD == 0 ? ALL_ONES : static_cast<word_type>((word_type(1) << N % BITS_PER_WORD) - 1);
+
+  std::array<word_type, WORD_COUNT> _words{};
+
+  template <typename Operation>
+  constexpr static_bitset& update(std::size_t pos, Operation operation) {
+    operation(_words[pos / BITS_PER_WORD], static_cast<word_type>(word_type(1) << pos % BITS_PER_WORD));
+    return *this;
+  }
+
+  constexpr static_bitset& clear_tail() {
+    if constexpr (WORD_COUNT != 0) {
+      _words[WORD_COUNT - 1] &= TAIL_MASK;
+    }
+    return *this;
+  }
+
+  constexpr std::size_t find_forward(std::size_t pos) const {
+    for (std::size_t index = pos / BITS_PER_WORD; index < WORD_COUNT; ++index) {
+      word_type word = _words[index];
+      if (index == pos / BITS_PER_WORD) {
+        word &= static_cast<word_type>(ALL_ONES << pos % BITS_PER_WORD);
+      }
+      if (word != 0) {
+        return index * BITS_PER_WORD + std::countr_zero(word);
+      }
+    }
+    return npos;
+  }
+
+public:
+  class const_iterator {
+    friend class static_bitset;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::size_t;
+    using pointer = void;
+
+    constexpr const_iterator() = default;
+
+    constexpr std::size_t operator*() const {
+      return _pos;
+    }
+
+    constexpr const_iterator& operator++() {
+      _pos = _bits->find_next(_pos);
+      return *this;
+    }
+
+    constexpr const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend constexpr bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs._pos == rhs._pos;
+    }
+
+  private:
+    const static_bitset* _bits = nullptr;
+    std::size_t _pos = npos;
+
+    constexpr const_iterator(const static_bitset* bits, std::size_t pos)
+        : _bits(bits)
+        , _pos(pos) {}
+  };
+};
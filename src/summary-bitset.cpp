@@ -0,0 +1,194 @@
+#include "summary-bitset.h"
+
+#include <bit>
+
+summary_bitset::summary_bitset() = default;
+
+summary_bitset::summary_bitset(std::size_t size)
+    : _bits(size, false)
+    , _non_zero((size + BITS_PER_WORD - 1) / BITS_PER_WORD, false)
+    , _non_full(_non_zero.size(), true) {}
+
+summary_bitset::summary_bitset(const bitset::const_view& bits)
+    : summary_bitset(bits.size()) {
+  _bits.subview().assign(bits);
+  rebuild_summaries();
+}
+
+std::size_t summary_bitset::size() const {
+  return _bits.size();
+}
+
+bool summary_bitset::empty() const {
+  return _bits.empty();
+}
+
+bool summary_bitset::test(std::size_t pos) const {
+  return _bits[pos];
+}
+
+void summary_bitset::set(std::size_t pos) {
+  _bits[pos] = true;
+  update_summary(pos / BITS_PER_WORD);
+}
+
+void summary_bitset::reset(std::size_t pos) {
+  _bits[pos] = false;
+  update_summary(pos / BITS_PER_WORD);
+}
+
+void summary_bitset::flip(std::size_t pos) {
+  _bits[pos].flip();
+  update_summary(pos / BITS_PER_WORD);
+}
+
+summary_bitset& summary_bitset::set() & {
+  _bits.set();
+  _non_zero.set();
+  _non_full.reset();
+  return *this;
+}
+
+summary_bitset& summary_bitset::reset() & {
+  _bits.reset();
+  _non_zero.reset();
+  _non_full.set();
+  return *this;
+}
+
+summary_bitset& summary_bitset::flip() & {
+  _bits.flip();
+  _non_zero.swap(_non_full);
+  return *this;
+}
+
+summary_bitset& summary_bitset::operator&=(const bitset::const_view& other) & {
+  _bits &= other;
+  rebuild_summaries();
+  return *this;
+}
+
+summary_bitset& summary_bitset::operator|=(const bitset::const_view& other) & {
+  _bits |= other;
+  rebuild_summaries();
+  return *this;
+}
+
+summary_bitset& summary_bitset::operator^=(const bitset::const_view& other) & {
+  _bits ^= other;
+  rebuild_summaries();
+  return *this;
+}
+
+summary_bitset& summary_bitset::andnot(const bitset::const_view& other) & {
+  _bits.andnot(other);
+  rebuild_summaries();
+  return *this;
+}
+
+std::size_t summary_bitset::count() const {
+  return _bits.count();
+}
+
+bool summary_bitset::any() const {
+  return _non_zero.any();
+}
+
+bool summary_bitset::all() const {
+  return !_non_full.any();
+}
+
+std::size_t summary_bitset::find_first() const {
+  return find_forward(0, true);
+}
+
+std::size_t summary_bitset::find_next(std::size_t pos) const {
+  return pos >= size() ? npos : find_forward(pos + 1, true);
+}
+
+std::size_t summary_bitset::find_first_zero() const {
+  return find_forward(0, false);
+}
+
+std::size_t summary_bitset::find_next_zero(std::size_t pos) const {
+  return pos >= size() ? npos : find_forward(pos + 1, false);
+}
+
+summary_bitset::const_iterator summary_bitset::begin() const {
+  return {this, find_first()};
+}
+
+summary_bitset::const_iterator summary_bitset::end() const {
+  return {this, npos};
+}
+
+bitset::const_view summary_bitset::bits() const {
+  return _bits.subview();
+}
+
+summary_bitset::operator bitset::const_view() const {
+  return bits();
+}
+
+// Bits past size() in the last word are not kept clear by every bitset
+// operation, so they are masked out here.
+summary_bitset::word_type summary_bitset::word(std::size_t index) const {
+  return bitset_leaf_expression(_bits.subview()).word(index) & valid_mask(index);
+}
+
+summary_bitset::word_type summary_bitset::valid_mask(std::size_t index) const {
+  std::size_t bits = size() - index * BITS_PER_WORD;
+  return bits >= BITS_PER_WORD ? ~word_type(0) : (word_type(1) << bits) - 1;
+}
+
+void summary_bitset::update_summary(std::size_t index) {
+  word_type bits = word(index);
+  _non_zero[index] = bits != 0;
+  _non_full[index] = bits != valid_mask(index);
+}
+
+void summary_bitset::rebuild_summaries() {
+  for (std::size_t i = 0; i < _non_zero.size(); ++i) {
+    update_summary(i);
+  }
+}
+
+std::size_t summary_bitset::find_forward(std::size_t pos, bool value) const {
+  if (pos >= size()) {
+    return npos;
+  }
+  auto candidates = [&](std::size_t index) { return value ? word(index) : ~word(index) & valid_mask(index); };
+  std::size_t index = pos / BITS_PER_WORD;
+  if (word_type bits = candidates(index) & (~word_type(0) << (pos % BITS_PER_WORD)); bits != 0) {
+    return index * BITS_PER_WORD + std::countr_zero(bits);
+  }
+  index = (value ? _non_zero : _non_full).find_next(index);
+  return index == npos ? npos : index * BITS_PER_WORD + std::countr_zero(candidates(index));
+}
+
+summary_bitset::const_iterator::const_iterator(const summary_bitset* bits, std::size_t pos)
+    : _bits(bits)
+    , _pos(pos) {}
+
+std::size_t summary_bitset::const_iterator::operator*() const {
+  return _pos;
+}
+
+summary_bitset::const_iterator& summary_bitset::const_iterator::operator++() {
+  _pos = _bits->find_next(_pos);
+  return *this;
+}
+
+summary_bitset::const_iterator summary_bitset::const_iterator::operator++(int) {
+  const_iterator tmp = *this;
+  ++(*this);
+  return tmp;
+}
+
+bool operator==(const summary_bitset& lhs, const summary_bitset& rhs) {
+  return lhs.bits() == rhs.bits();
+}
+
+bool operator!=(const summary_bitset& lhs, const summary_bitset& rhs) {
+  return !(lhs == rhs);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// Bitset that keeps two summary bits per data word: whether the word has any
+// one and whether it has any zero. Searches consult the summaries first, so
+// they skip 64 empty (or full) words per summary word read, and any()/all()
+// only look at the summaries. Every mutating operation keeps them in sync;
+// the data is only exposed read-only for that reason.
+class summary_bitset {
+public:
+  using word_type = bitset::word_type;
+
+  static constexpr std::size_t npos = bitset::npos;
+  static constexpr std::size_t BITS_PER_WORD = bitset::BITS_PER_WORD;
+
+  class const_iterator;
+
+  summary_bitset();
+  explicit summary_bitset(std::size_t size);
+  explicit summary_bitset(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  bool test(std::size_t pos) const;
+  void set(std::size_t pos);
+  void reset(std::size_t pos);
+  void flip(std::size_t pos);
+
+  summary_bitset& set() &;
+  summary_bitset& reset() &;
+  summary_bitset& flip() &;
+
+  summary_bitset& operator&=(const bitset::const_view& other) &;
+  summary_bitset& operator|=(const bitset::const_view& other) &;
+  summary_bitset& operator^=(const bitset::const_view& other) &;
+  summary_bitset& andnot(const bitset::const_view& other) &;
+
+  std::size_t count() const;
+  bool any() const;
+  bool all() const;
+
+  std::size_t find_first() const;
+  std::size_t find_next(std::size_t pos) const;
+  std::size_t find_first_zero() const;
+  std::size_t find_next_zero(std::size_t pos) const;
+
+  // Positions of the set bits in increasing order.
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  bitset::const_view bits() const;
+  operator bitset::const_view() const;
+
+  friend bool operator==(const summary_bitset& lhs, const summary_bitset& rhs);
+
+private:
+  bitset _bits;
+  // One bit per word of `_bits`.
+  bitset _non_zero;
+  bitset _non_full;
+
+  word_type word(std::size_t index) const;
+  word_type valid_mask(std::size_t index) const;
+  void update_summary(std::size_t index);
+  void rebuild_summaries();
+  // First position >= `pos` holding `value`, or npos.
+  std::size_t find_forward(std::size_t pos, bool value) const;
+
+public:
+  class const_iterator {
+    friend class summary_bitset;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::size_t;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    std::size_t operator*() const;
+
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs._pos == rhs._pos;
+    }
+
+  private:
+    const summary_bitset* _bits = nullptr;
+    std::size_t _pos = npos;
+
+    const_iterator(const summary_bitset* bits, std::size_t pos);
+  };
+};
+
+bool operator!=(const summary_bitset& lhs, const summary_bitset& rhs);
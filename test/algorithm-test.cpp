@@ -0,0 +1,164 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <string>
+
+TEST_CASE("copy and move") {
+  std::string src_str = random_bit_string(300, 11);
+  std::string dst_str = random_bit_string(300, 12);
+  const bitset src(src_str);
+  bitset dst(dst_str);
+
+  std::size_t src_offset = GENERATE(0, 3, 64);
+  std::size_t dst_offset = GENERATE(0, 9, 128);
+  std::size_t count = GENERATE(0, 1, 100, 170);
+  CAPTURE(src_offset, dst_offset, count);
+
+  using std::copy;
+  auto result = copy(src.begin() + src_offset, src.begin() + src_offset + count, dst.begin() + dst_offset);
+  CHECK(result == dst.begin() + dst_offset + count);
+
+  dst_str.replace(dst_offset, count, src_str, src_offset, count);
+  CHECK_THAT(dst, bitset_equals_string(dst_str));
+
+  using std::move;
+  move(dst.begin(), dst.begin() + 90, dst.begin() + 100);
+  std::copy(dst_str.begin(), dst_str.begin() + 90, dst_str.begin() + 100);
+  CHECK_THAT(dst, bitset_equals_string(dst_str));
+}
+
+TEST_CASE("overlapping copy and copy_backward") {
+  std::string str = random_bit_string(400, 13);
+  bitset bs(str);
+
+  std::size_t shift = GENERATE(1, 7, 64, 100);
+  CAPTURE(shift);
+
+  SECTION("copy to the left") {
+    using std::copy;
+    copy(bs.begin() + shift, bs.end(), bs.begin());
+    std::copy(str.begin() + shift, str.end(), str.begin());
+    CHECK_THAT(bs, bitset_equals_string(str));
+  }
+
+  SECTION("copy_backward to the right") {
+    using std::copy_backward;
+    auto result = copy_backward(bs.begin(), bs.end() - shift, bs.end());
+    std::copy_backward(str.begin(), str.end() - shift, str.end());
+    CHECK(result == bs.begin() + shift);
+    CHECK_THAT(bs, bitset_equals_string(str));
+  }
+}
+
+TEST_CASE("fill and fill_n") {
+  std::string str = random_bit_string(200, 14);
+  bitset bs(str);
+  bool value = GENERATE(false, true);
+  CAPTURE(value);
+
+  using std::fill;
+  using std::fill_n;
+  fill(bs.begin() + 3, bs.begin() + 150, value);
+  std::fill(str.begin() + 3, str.begin() + 150, value ? '1' : '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  auto result = fill_n(bs.begin() + 170, 20, !value);
+  std::fill_n(str.begin() + 170, 20, value ? '0' : '1');
+  CHECK(result == bs.begin() + 190);
+  CHECK_THAT(bs, bitset_equals_string(str));
+}
+
+TEST_CASE("equal, count and find") {
+  std::string str = random_bit_string(300, 15);
+  const bitset bs(str);
+  const bitset other(str);
+
+  using std::count;
+  using std::equal;
+  using std::find;
+
+  CHECK(equal(bs.begin() + 5, bs.end(), other.begin() + 5));
+  CHECK_FALSE(equal(bs.begin() + 5, bs.end(), other.begin() + 6));
+
+  CHECK(count(bs.begin() + 10, bs.end(), true) == std::count(str.begin() + 10, str.end(), '1'));
+  CHECK(count(bs.begin() + 10, bs.end(), false) == std::count(str.begin() + 10, str.end(), '0'));
+
+  bitset sparse(300, false);
+  sparse[0] = true;
+  sparse[250] = true;
+  CHECK(find(sparse.begin() + 1, sparse.end(), true) == sparse.begin() + 250);
+  CHECK(find(sparse.begin() + 251, sparse.end(), true) == sparse.end());
+  CHECK(find(sparse.begin(), sparse.end(), false) == sparse.begin() + 1);
+
+  const bitset ones(130, true);
+  CHECK(find(ones.begin(), ones.end(), false) == ones.end());
+}
+
+TEST_CASE("swap_ranges and rotate") {
+  std::string str_1 = random_bit_string(300, 16);
+  std::string str_2 = random_bit_string(300, 17);
+  bitset bs_1(str_1);
+  bitset bs_2(str_2);
+
+  SECTION("swap_ranges") {
+    using std::swap_ranges;
+    auto result = swap_ranges(bs_1.begin() + 3, bs_1.begin() + 203, bs_2.begin() + 70);
+    std::swap_ranges(str_1.begin() + 3, str_1.begin() + 203, str_2.begin() + 70);
+    CHECK(result == bs_2.begin() + 270);
+    CHECK_THAT(bs_1, bitset_equals_string(str_1));
+    CHECK_THAT(bs_2, bitset_equals_string(str_2));
+  }
+
+  SECTION("rotate") {
+    std::size_t middle = GENERATE(0, 1, 64, 77, 299, 300);
+    CAPTURE(middle);
+
+    using std::rotate;
+    auto result = rotate(bs_1.begin(), bs_1.begin() + middle, bs_1.end());
+    auto expected = std::rotate(str_1.begin(), str_1.begin() + middle, str_1.end());
+    CHECK(result - bs_1.begin() == expected - str_1.begin());
+    CHECK_THAT(bs_1, bitset_equals_string(str_1));
+  }
+}
+
+TEST_CASE("algorithms on ranges larger than the scratch buffer") {
+  std::string str_1 = random_bit_string(20000, 18);
+  std::string str_2 = random_bit_string(20000, 19);
+  bitset bs_1(str_1);
+  bitset bs_2(str_2);
+
+  SECTION("copy_backward") {
+    std::size_t shift = GENERATE(1, 65, 5000);
+    CAPTURE(shift);
+
+    using std::copy_backward;
+    auto result = copy_backward(bs_1.begin() + 3, bs_1.end() - shift, bs_1.end());
+    std::copy_backward(str_1.begin() + 3, str_1.end() - shift, str_1.end());
+    CHECK(result == bs_1.begin() + 3 + shift);
+    CHECK_THAT(bs_1, bitset_equals_string(str_1));
+  }
+
+  SECTION("swap_ranges") {
+    using std::swap_ranges;
+    auto result = swap_ranges(bs_1.begin() + 5, bs_1.begin() + 15005, bs_2.begin() + 1);
+    std::swap_ranges(str_1.begin() + 5, str_1.begin() + 15005, str_2.begin() + 1);
+    CHECK(result == bs_2.begin() + 15001);
+    CHECK_THAT(bs_1, bitset_equals_string(str_1));
+    CHECK_THAT(bs_2, bitset_equals_string(str_2));
+  }
+
+  SECTION("rotate") {
+    std::size_t middle = GENERATE(8, 4103, 4104, 9999, 10003, 15903, 15904, 19999);
+    CAPTURE(middle);
+
+    using std::rotate;
+    auto result = rotate(bs_1.begin() + 7, bs_1.begin() + middle, bs_1.end());
+    auto expected = std::rotate(str_1.begin() + 7, str_1.begin() + middle, str_1.end());
+    CHECK(result - bs_1.begin() == expected - str_1.begin());
+    CHECK_THAT(bs_1, bitset_equals_string(str_1));
+  }
+}
@@ -0,0 +1,100 @@
+#include "atomic-bitset.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+TEST_CASE("atomic bitset single-threaded") {
+  std::size_t size = GENERATE(0, 1, 64, 130);
+  CAPTURE(size);
+
+  atomic_bitset bits(size);
+  CHECK(bits.size() == size);
+  CHECK(bits.count() == 0);
+  CHECK_FALSE(bits.any());
+
+  for (std::size_t i = 0; i < size; i += 3) {
+    CHECK_FALSE(bits.test_and_set(i));
+    CHECK(bits.test_and_set(i, std::memory_order_relaxed));
+    CHECK(bits.test(i));
+  }
+  CHECK(bits.count() == (size + 2) / 3);
+  CHECK(bits.any() == (size != 0));
+
+  for (std::size_t i = 0; i < size; i += 6) {
+    CHECK(bits.test_and_reset(i, std::memory_order_acq_rel));
+    CHECK_FALSE(bits.test_and_reset(i));
+    CHECK_FALSE(bits.test(i, std::memory_order_acquire));
+  }
+
+  bitset expected(size, false);
+  for (std::size_t i = 3; i < size; i += 6) {
+    expected[i] = true;
+  }
+  CHECK(bits.to_bitset() == expected);
+
+  bits.clear();
+  CHECK_FALSE(bits.any());
+}
+
+TEST_CASE("atomic bitset word operations") {
+  atomic_bitset bits(128);
+  CHECK(bits.word_count() == 2);
+  CHECK(bits.fetch_or(1, 0xf0) == 0);
+  CHECK(bits.fetch_or(1, 0x0f) == 0xf0);
+  CHECK(bits.fetch_and(1, 0x3c) == 0xff);
+  CHECK(bits.fetch_xor(1, 0x0f) == 0x3c);
+  CHECK(bits.load_word(1) == 0x33);
+
+  bitset::word_type expected = 0x32;
+  CHECK_FALSE(bits.compare_exchange_word(1, expected, 0));
+  CHECK(expected == 0x33);
+  while (!bits.compare_exchange_word(1, expected, 0x100)) {}
+  CHECK(bits.load_word(1) == 0x100);
+  CHECK(bits.test(64 + 8));
+}
+
+TEST_CASE("atomic bitset round trip through bitset") {
+  std::size_t size = GENERATE(0, 63, 1000);
+  std::size_t offset = GENERATE(0, 11);
+  CAPTURE(size, offset);
+  bitset source(random_bit_string(size + offset, 5));
+  atomic_bitset bits(source.subview(offset));
+  CHECK(bits.to_bitset() == source.subview(offset));
+  CHECK(bits.count() == source.subview(offset).count());
+
+  atomic_bitset moved(std::move(bits));
+  CHECK(moved.size() == size);
+  CHECK(moved.to_bitset() == source.subview(offset));
+}
+
+TEST_CASE("atomic bitset concurrent test_and_set") {
+  constexpr std::size_t THREADS = 8;
+  constexpr std::size_t SIZE = 10000;
+  atomic_bitset bits(SIZE);
+  std::atomic<std::size_t> claimed = 0;
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (std::size_t i = 0; i < SIZE; ++i) {
+        std::size_t pos = (i + t * 997) % SIZE;
+        if (!bits.test_and_set(pos, std::memory_order_relaxed)) {
+          claimed.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  CHECK(claimed.load() == SIZE);
+  CHECK(bits.count() == SIZE);
+}
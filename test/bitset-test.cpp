@@ -6,9 +6,13 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("bitset default constructor") {
   bitset bs;
@@ -108,6 +112,35 @@ TEST_CASE("bitset copy constructor") {
   }
 }
 
+TEST_CASE("bitset move constructor") {
+  std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  bitset bs(str);
+  bitset::view before = bs.subview();
+
+  bitset moved = std::move(bs);
+
+  CHECK_THAT(moved, bitset_equals_string(str));
+  CHECK(bs.empty());
+  // The words were handed over rather than copied, so a view taken before
+  // the move sees writes made through the new owner.
+  moved[1].flip();
+  CHECK(before == moved);
+}
+
+TEST_CASE("bitset move assignment") {
+  std::string_view str = "1101101";
+  bitset bs(str);
+  bitset other("11110110111010000100101111101000011011111111000001100110010010001011100100110101");
+  bitset::view before = bs.subview();
+
+  other = std::move(bs);
+
+  CHECK_THAT(other, bitset_equals_string(str));
+  CHECK(bs.empty());
+  other[0].flip();
+  CHECK(before == other);
+}
+
 TEST_CASE("bitset constructor from view") {
   SECTION("empty") {
     const bitset source("1101101");
@@ -146,6 +179,78 @@ TEST_CASE("bitset constructor from view") {
   }
 }
 
+TEST_CASE("bitset constructor from long view") {
+  std::string str = random_bit_string(1000, 7);
+  const bitset source(str);
+
+  std::size_t offset = GENERATE(0, 1, 63, 64, 65, 300);
+  std::size_t count = GENERATE(1, 64, 128, 500, 700);
+  CAPTURE(offset, count);
+
+  bitset bs(source.subview(offset, count));
+  CHECK_THAT(bs, bitset_equals_string(std::string_view(str).substr(offset, count)));
+
+  bitset copy = bs;
+  CHECK_THAT(copy, bitset_equals_string(std::string_view(str).substr(offset, count)));
+}
+
+TEST_CASE("view assign") {
+  std::string str = random_bit_string(400, 8);
+  const bitset source(str);
+  bitset bs(400, false);
+
+  std::size_t dst_offset = GENERATE(0, 5, 64);
+  std::size_t src_offset = GENERATE(0, 17, 128);
+  CAPTURE(dst_offset, src_offset);
+
+  bs.subview(dst_offset, 250).assign(source.subview(src_offset, 250));
+
+  std::string expected(400, '0');
+  expected.replace(dst_offset, 250, str, src_offset, 250);
+  CHECK_THAT(bs, bitset_equals_string(expected));
+}
+
+TEST_CASE("bitset from indices") {
+  SECTION("empty") {
+    bitset bs = bitset::from_indices(100, std::vector<uint32_t>{});
+    CHECK(bs == bitset(100, false));
+  }
+
+  SECTION("sorted and unsorted") {
+    std::vector<uint64_t> indices = {0, 1, 63, 64, 65, 200, 201, 999};
+    bool sorted = GENERATE(true, false);
+    CAPTURE(sorted);
+    if (!sorted) {
+      std::shuffle(indices.begin(), indices.end(), std::mt19937(5));
+      indices.push_back(64);
+    }
+
+    bitset bs = bitset::from_indices(1000, indices);
+    std::string expected(1000, '0');
+    for (uint64_t index : indices) {
+      expected[index] = '1';
+    }
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("set_many keeps existing bits and respects views") {
+    std::string str = random_bit_string(300, 61);
+    bitset bs(str);
+    std::vector<uint32_t> indices = {5, 7, 100, 4, 150};
+
+    bs.subview(37).set_many(indices);
+    for (uint32_t index : indices) {
+      str[37 + index] = '1';
+    }
+    CHECK_THAT(bs, bitset_equals_string(str));
+
+    bs.set_many(std::vector<uint32_t>{299, 0});
+    str[299] = '1';
+    str[0] = '1';
+    CHECK_THAT(bs, bitset_equals_string(str));
+  }
+}
+
 TEST_CASE("to_string(bitset)") {
   std::string_view str = "11010001001101000100110100010011010001001101000100110100010011010001001101000100";
   const bitset bs(str);
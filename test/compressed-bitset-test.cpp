@@ -0,0 +1,217 @@
+#include "compressed-bitset.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Chunk 0 is sparse, chunk 1 is dense noise, chunk 2 is a few long runs,
+// chunk 3 is empty and the last, partial chunk is sparse again.
+bitset mixed_bitset(unsigned seed) {
+  constexpr std::size_t chunk = compressed_bitset::CHUNK_BITS;
+  bitset result(4 * chunk + 1000, false);
+  std::string noise = random_bit_string(chunk, seed);
+  for (std::size_t i = 0; i < chunk; ++i) {
+    if (i % (97 + seed) == 0) {
+      result[i] = true;
+    }
+    result[chunk + i] = noise[i] == '1';
+  }
+  result.subview(2 * chunk + 100 * seed, 5000).set();
+  result.subview(2 * chunk + 30000, 20000 + seed).set();
+  result[4 * chunk + seed] = true;
+  result[4 * chunk + 999] = true;
+  return result;
+}
+
+std::vector<std::size_t> set_positions(const bitset& bs) {
+  std::vector<std::size_t> result;
+  for (std::size_t pos : bs.ones()) {
+    result.push_back(pos);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("compressed bitset round trips through bitset") {
+  std::size_t size = GENERATE(0, 1, 65, 70000);
+  std::string str = random_bit_string(size, 5);
+  const bitset bs(str);
+  compressed_bitset cbs(bs);
+  CHECK(cbs.size() == size);
+  CHECK(cbs.count() == bs.count());
+  CHECK(cbs.any() == bs.any());
+  CHECK(cbs.to_bitset() == bs);
+
+  const bitset mixed = mixed_bitset(3);
+  compressed_bitset cmixed(mixed);
+  CHECK(cmixed.count() == mixed.count());
+  CHECK(cmixed.to_bitset() == mixed);
+
+  compressed_bitset from_view(mixed.subview(7, 100000));
+  CHECK(from_view.to_bitset() == bitset(mixed.subview(7, 100000)));
+}
+
+TEST_CASE("compressed bitset test, set and reset") {
+  compressed_bitset cbs(200000);
+  CHECK_FALSE(cbs.any());
+  CHECK(cbs.count() == 0);
+  cbs.set(5);
+  cbs.set(150000);
+  cbs.set(5);
+  CHECK(cbs.count() == 2);
+  CHECK(cbs.test(5));
+  CHECK(cbs.test(150000));
+  CHECK_FALSE(cbs.test(6));
+  cbs.reset(5);
+  CHECK_FALSE(cbs.test(5));
+  cbs.reset(150000);
+  CHECK_FALSE(cbs.any());
+  CHECK(cbs == compressed_bitset(200000));
+
+  CHECK_THROWS_AS(cbs.set(200000), std::out_of_range);
+  CHECK_THROWS_AS(cbs.reset(200000), std::out_of_range);
+  CHECK_THROWS_AS(compressed_bitset().set(0), std::out_of_range);
+  CHECK(cbs == compressed_bitset(200000));
+}
+
+TEST_CASE("compressed bitset set and reset across container kinds") {
+  constexpr std::size_t chunk = compressed_bitset::CHUNK_BITS;
+  // Chunk 0 starts empty, chunk 1 as long runs and chunk 2 as dense noise.
+  bitset expected(3 * chunk, false);
+  for (std::size_t pos = chunk; pos < 2 * chunk; pos += 4096) {
+    expected.subview(pos, 3000).set();
+  }
+  std::string noise = random_bit_string(chunk, 7);
+  for (std::size_t i = 0; i < chunk; ++i) {
+    expected[2 * chunk + i] = noise[i] == '1';
+  }
+  compressed_bitset cbs(expected);
+
+  std::mt19937 rng(3);
+  auto check = [&] {
+    REQUIRE(cbs.to_bitset() == expected);
+    CHECK(cbs.count() == expected.count());
+    CHECK(cbs == compressed_bitset(expected));
+    std::vector<std::size_t> positions(cbs.begin(), cbs.end());
+    CHECK(positions == set_positions(expected));
+  };
+
+  SECTION("growing and shrinking a chunk") {
+    for (std::size_t i = 0; i < 6000; ++i) {
+      std::size_t pos = rng() % chunk;
+      cbs.set(pos);
+      expected[pos] = true;
+    }
+    check();
+    for (std::size_t pos = 0; pos < chunk; ++pos) {
+      if (pos % 3 != 0) {
+        cbs.reset(pos);
+        expected[pos] = false;
+      }
+    }
+    check();
+  }
+
+  SECTION("random updates") {
+    for (std::size_t round = 0; round < 4; ++round) {
+      for (std::size_t i = 0; i < 5000; ++i) {
+        std::size_t pos = rng() % expected.size();
+        if (rng() % 2 == 0) {
+          cbs.set(pos);
+          expected[pos] = true;
+        } else {
+          cbs.reset(pos);
+          expected[pos] = false;
+        }
+        CHECK(cbs.test(pos) == expected[pos]);
+      }
+      check();
+    }
+  }
+
+  SECTION("splitting and joining runs") {
+    for (std::size_t pos = chunk + 100; pos < chunk + 3000; pos += 2) {
+      cbs.reset(pos);
+      expected[pos] = false;
+    }
+    check();
+    for (std::size_t pos = chunk + 3000; pos < chunk + 4096; ++pos) {
+      cbs.set(pos);
+      expected[pos] = true;
+    }
+    check();
+    for (std::size_t pos = chunk; pos < 2 * chunk; ++pos) {
+      cbs.reset(pos);
+      expected[pos] = false;
+    }
+    check();
+  }
+}
+
+TEST_CASE("compressed bitset iterates set bits in order") {
+  const bitset bs = mixed_bitset(1);
+  compressed_bitset cbs(bs);
+  std::vector<std::size_t> positions(cbs.begin(), cbs.end());
+  CHECK(positions == set_positions(bs));
+  CHECK(compressed_bitset(100).begin() == compressed_bitset(100).end());
+}
+
+TEST_CASE("compressed bitset with many runs per chunk") {
+  bitset bs(3 * compressed_bitset::CHUNK_BITS, false);
+  for (std::size_t pos = 0; pos < bs.size(); pos += 64) {
+    bs.subview(pos + pos / 64 % 7, 20 + pos / 64 % 13).set();
+  }
+  compressed_bitset cbs(bs);
+  std::vector<std::size_t> positions(cbs.begin(), cbs.end());
+  CHECK(positions == set_positions(bs));
+  for (std::size_t pos = 0; pos < bs.size(); pos += 5) {
+    CHECK(cbs.test(pos) == bs[pos]);
+  }
+}
+
+TEST_CASE("compressed bitset operations agree with bitset") {
+  const bitset lhs = mixed_bitset(1);
+  const bitset rhs = mixed_bitset(2);
+  const compressed_bitset clhs(lhs);
+  const compressed_bitset crhs(rhs);
+
+  bitset not_rhs = ~rhs;
+
+  SECTION("compressed with compressed") {
+    CHECK((clhs & crhs).to_bitset() == (lhs & rhs));
+    CHECK((clhs | crhs).to_bitset() == (lhs | rhs));
+    CHECK((clhs ^ crhs).to_bitset() == (lhs ^ rhs));
+    CHECK(andnot(clhs, crhs).to_bitset() == (lhs & not_rhs));
+    CHECK((clhs & crhs).count() == (lhs & rhs).count());
+    CHECK((clhs ^ clhs).count() == 0);
+  }
+
+  SECTION("compressed with view") {
+    CHECK((clhs & rhs).to_bitset() == (lhs & rhs));
+    CHECK((clhs | rhs).to_bitset() == (lhs | rhs));
+    CHECK((clhs ^ rhs).to_bitset() == (lhs ^ rhs));
+    CHECK(andnot(clhs, rhs).to_bitset() == (lhs & not_rhs));
+  }
+
+  SECTION("view with compressed") {
+    CHECK((lhs & crhs).to_bitset() == (lhs & rhs));
+    CHECK((lhs | crhs).to_bitset() == (lhs | rhs));
+    CHECK((lhs ^ crhs).to_bitset() == (lhs ^ rhs));
+    CHECK(andnot(lhs, crhs).to_bitset() == (lhs & not_rhs));
+  }
+
+  SECTION("results are canonical") {
+    CHECK((clhs | crhs) == compressed_bitset(lhs | rhs));
+    CHECK((clhs & rhs) == compressed_bitset(lhs & rhs));
+  }
+}
@@ -0,0 +1,84 @@
+#include "ewah-bitset.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+
+namespace {
+
+// Long zero and one runs, some of them not word aligned, with noise between.
+bitset runs_bitset(std::size_t size, unsigned seed) {
+  std::string str(size, '0');
+  std::string noise = random_bit_string(size, seed);
+  for (std::size_t i = 0; i < size; ++i) {
+    std::size_t block = (i + 37 * seed) / 1000;
+    if (block % 3 == 1) {
+      str[i] = '1';
+    } else if (block % 5 == 2) {
+      str[i] = noise[i];
+    }
+  }
+  return bitset(str);
+}
+
+} // namespace
+
+TEST_CASE("ewah bitset round trips through bitset") {
+  std::size_t size = GENERATE(0, 1, 63, 64, 65, 128, 10000, 10037);
+  unsigned seed = GENERATE(1u, 2u);
+  CAPTURE(size, seed);
+
+  const bitset bs = runs_bitset(size, seed);
+  ewah_bitset ebs(bs);
+  CHECK(ebs.size() == size);
+  CHECK(ebs.count() == bs.count());
+  CHECK(ebs.any() == bs.any());
+  CHECK(ebs.to_bitset() == bs);
+
+  const bitset noise(random_bit_string(size, seed));
+  CHECK(ewah_bitset(noise).to_bitset() == noise);
+  CHECK(ewah_bitset(bitset(size, true)).to_bitset() == bitset(size, true));
+  CHECK(ewah_bitset(bitset(size, false)) == ewah_bitset(size));
+}
+
+TEST_CASE("ewah bitset compresses runs") {
+  bitset bs(1 << 20, false);
+  bs.subview(1000, 300000).set();
+  bs[700000] = true;
+  ewah_bitset ebs(bs);
+  CHECK(ebs.buffer_size() <= 8);
+  CHECK(ebs.count() == 300001);
+  CHECK(ebs.to_bitset() == bs);
+}
+
+TEST_CASE("ewah bitset decodes into a view") {
+  const bitset bs = runs_bitset(5000, 3);
+  bitset target(5100, true);
+  ewah_bitset(bs).decode(target.subview(50, 5000));
+  CHECK(bitset(target.subview(50, 5000)) == bs);
+  CHECK(target.subview(0, 50).all());
+  CHECK(target.subview(5050).all());
+}
+
+TEST_CASE("ewah bitset operations agree with bitset") {
+  std::size_t size = GENERATE(0, 100, 10037, 64000);
+  CAPTURE(size);
+  const bitset lhs = runs_bitset(size, 1);
+  const bitset rhs = runs_bitset(size, 4);
+  const ewah_bitset elhs(lhs);
+  const ewah_bitset erhs(rhs);
+
+  CHECK((elhs & erhs).to_bitset() == (lhs & rhs));
+  CHECK((elhs | erhs).to_bitset() == (lhs | rhs));
+  CHECK((elhs ^ erhs).to_bitset() == (lhs ^ rhs));
+  CHECK((elhs & erhs).count() == (lhs & rhs).count());
+  CHECK((elhs ^ elhs) == ewah_bitset(size));
+  CHECK((elhs | erhs) == ewah_bitset(lhs | rhs));
+
+  const bitset noise(random_bit_string(size, 9));
+  CHECK((elhs & ewah_bitset(noise)).to_bitset() == (lhs & noise));
+  CHECK((elhs ^ ewah_bitset(noise)).to_bitset() == (lhs ^ noise));
+}
@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <array>
+#include <random>
+#include <string>
 #include <utility>
 
 TEST_CASE("left shift") {
@@ -107,6 +109,49 @@ TEST_CASE("right shift") {
   }
 }
 
+TEST_CASE("shifts reuse capacity") {
+  std::string str = random_bit_string(200, 21);
+  bitset bs(str);
+
+  std::size_t shrink = GENERATE(0, 1, 70, 130, 200, 250);
+  std::size_t grow = GENERATE(0, 5, 70, 300);
+  CAPTURE(shrink, grow);
+
+  bs >>= shrink;
+  str.erase(str.size() - std::min(shrink, str.size()));
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs <<= grow;
+  str.append(grow, '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+}
+
+TEST_CASE("memory stays proportional to size across shifts") {
+  bitset bs(10, true);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    bs <<= 3;
+    CHECK(bs.capacity() >= bs.size());
+    CHECK(bs.capacity() <= bs.size() + 1024);
+  }
+  CHECK(bs.size() == 3010);
+  CHECK(bs.count() == 10);
+
+  bs >>= 3000;
+  CHECK(bs.size() == 10);
+  CHECK(bs.capacity() <= bs.size() + 1024);
+  CHECK(bs.count() == 10);
+}
+
+TEST_CASE("left shift after right shift clears the vacated bits") {
+  bitset bs(300, true);
+  bs >>= 200;
+  bs <<= 150;
+  CHECK(bs.size() == 250);
+  CHECK(bs.count() == 100);
+  CHECK(bs.subview(0, 100).all());
+  CHECK_FALSE(bs.subview(100).any());
+}
+
 TEST_CASE("bitwise operations") {
   SECTION("empty") {
     bitset bs;
@@ -308,6 +353,29 @@ TEST_CASE("bitset::all/any/count") {
   }
 }
 
+TEST_CASE("comparison of differently aligned views") {
+  std::string str = random_bit_string(600, 33);
+  std::size_t lhs_offset = GENERATE(0, 5, 64, 100);
+  std::size_t rhs_offset = GENERATE(0, 1, 63, 200);
+  std::size_t count = GENERATE(0, 1, 60, 64, 130, 256);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  // Both copies hold the same bits at different offsets.
+  std::string padded = std::string(rhs_offset, '0') + str.substr(lhs_offset, count) + "1";
+  const bitset lhs(str);
+  bitset rhs(padded);
+  CHECK(lhs.subview(lhs_offset, count) == rhs.subview(rhs_offset, count));
+
+  for (std::size_t pos : {std::size_t(0), count / 2, count - 1}) {
+    if (pos < count) {
+      rhs[rhs_offset + pos].flip();
+      CHECK(lhs.subview(lhs_offset, count) != rhs.subview(rhs_offset, count));
+      rhs[rhs_offset + pos].flip();
+    }
+  }
+  CHECK(lhs.subview(lhs_offset, count) != rhs.subview(rhs_offset, count + 1));
+}
+
 TEST_CASE("bitset comparison") {
   SECTION("empty") {
     bitset bs_1;
@@ -412,3 +480,282 @@ TEST_CASE("chained view operations") {
   CHECK(bs_1 == bitset("0010000001"));
   CHECK(bs_2 == bitset("1110010101"));
 }
+
+TEST_CASE("bitwise operations on long subviews") {
+  std::mt19937 gen(42);
+  std::string lhs_str(300, '0');
+  std::string rhs_str(300, '0');
+  for (std::size_t i = 0; i < lhs_str.size(); ++i) {
+    lhs_str[i] = static_cast<char>('0' + gen() % 2);
+    rhs_str[i] = static_cast<char>('0' + gen() % 2);
+  }
+
+  std::size_t lhs_offset = GENERATE(0, 3, 64, 70);
+  std::size_t rhs_offset = GENERATE(0, 5, 64, 127);
+  std::size_t count = GENERATE(0, 1, 63, 64, 65, 150);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+  std::string expected = lhs_str;
+
+  auto apply = [&](auto operation) {
+    for (std::size_t i = 0; i < count; ++i) {
+      bool result = operation(lhs_str[lhs_offset + i] == '1', rhs_str[rhs_offset + i] == '1');
+      expected[lhs_offset + i] = result ? '1' : '0';
+    }
+  };
+
+  SECTION("bitwise and") {
+    lhs.subview(lhs_offset, count) &= rhs.subview(rhs_offset, count);
+    apply([](bool a, bool b) { return a && b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise or") {
+    lhs.subview(lhs_offset, count) |= rhs.subview(rhs_offset, count);
+    apply([](bool a, bool b) { return a || b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise xor") {
+    lhs.subview(lhs_offset, count) ^= rhs.subview(rhs_offset, count);
+    apply([](bool a, bool b) { return a != b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("andnot") {
+    lhs.subview(lhs_offset, count).andnot(rhs.subview(rhs_offset, count));
+    apply([](bool a, bool b) { return a && !b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("flip") {
+    lhs.subview(lhs_offset, count).flip();
+    apply([](bool a, bool) { return !a; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("set") {
+    lhs.subview(lhs_offset, count).set();
+    apply([](bool, bool) { return true; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("reset") {
+    lhs.subview(lhs_offset, count).reset();
+    apply([](bool, bool) { return false; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+}
+
+// The destination is word-aligned after its head and the source is not, so
+// every body word is combined from two neighbouring source words.
+TEST_CASE("bitwise operations with differently aligned source and destination") {
+  constexpr std::size_t SOURCE_SIZE = 512;
+  std::mt19937 gen(31);
+  std::string dst_str(1024, '0');
+  std::string src_str(SOURCE_SIZE, '0');
+  for (char& c : dst_str) {
+    c = static_cast<char>('0' + gen() % 2);
+  }
+  for (char& c : src_str) {
+    c = static_cast<char>('0' + gen() % 2);
+  }
+
+  std::size_t dst_offset = GENERATE(0, 13, 64, 100);
+  std::size_t src_offset = GENERATE(1, 37, 63, 101, 255);
+  // Counts past the end of the source are clamped, so the source then ends on
+  // a word boundary.
+  std::size_t count = std::min(GENERATE(std::size_t(65), 130, 191, 256, 300, 512), SOURCE_SIZE - src_offset);
+  CAPTURE(dst_offset, src_offset, count);
+
+  bitset dst(dst_str);
+  const bitset src(src_str);
+  std::string expected = dst_str;
+
+  auto apply = [&](auto operation) {
+    for (std::size_t i = 0; i < count; ++i) {
+      bool result = operation(dst_str[dst_offset + i] == '1', src_str[src_offset + i] == '1');
+      expected[dst_offset + i] = result ? '1' : '0';
+    }
+  };
+
+  SECTION("bitwise and") {
+    dst.subview(dst_offset, count) &= src.subview(src_offset, count);
+    apply([](bool a, bool b) { return a && b; });
+    CHECK_THAT(dst, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise or") {
+    dst.subview(dst_offset, count) |= src.subview(src_offset, count);
+    apply([](bool a, bool b) { return a || b; });
+    CHECK_THAT(dst, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise xor") {
+    dst.subview(dst_offset, count) ^= src.subview(src_offset, count);
+    apply([](bool a, bool b) { return a != b; });
+    CHECK_THAT(dst, bitset_equals_string(expected));
+  }
+}
+
+TEST_CASE("binary operations on temporaries") {
+  const bitset lhs("1101101");
+  const bitset rhs("0111001");
+
+  CHECK_THAT(bitset(lhs) & rhs, bitset_equals_string("0101001"));
+  CHECK_THAT(lhs | bitset(rhs), bitset_equals_string("1111101"));
+  CHECK_THAT(bitset(lhs) ^ bitset(rhs), bitset_equals_string("1010100"));
+  CHECK_THAT(~bitset(lhs), bitset_equals_string("0010010"));
+  CHECK_THAT(bitset(lhs) << 2, bitset_equals_string("110110100"));
+  CHECK_THAT(bitset(lhs) >> 2, bitset_equals_string("11011"));
+  CHECK_THAT((bitset(lhs) & rhs) | lhs, bitset_equals_string("1101101"));
+}
+
+TEST_CASE("lazy bitwise expressions") {
+  std::size_t size = GENERATE(0, 1, 63, 64, 65, 300);
+  std::size_t offset = GENERATE(0, 5, 64);
+  CAPTURE(size, offset);
+
+  std::array<std::string, 4> strs;
+  for (std::size_t i = 0; i < strs.size(); ++i) {
+    strs[i] = random_bit_string(size + offset, static_cast<unsigned>(i + 1));
+  }
+  const bitset a(strs[0].substr(0, size));
+  const bitset b(strs[1].substr(0, size));
+  const bitset c_storage(strs[2]);
+  const bitset d_storage(strs[3]);
+  bitset::const_view c = c_storage.subview(offset);
+  bitset::const_view d = d_storage.subview(offset);
+
+  std::string expected(size, '0');
+  for (std::size_t i = 0; i < size; ++i) {
+    bool value = (strs[0][i] == '1' && strs[1][i] == '1') || strs[2][offset + i] == strs[3][offset + i];
+    expected[i] = value ? '1' : '0';
+  }
+  std::size_t expected_count = std::count(expected.begin(), expected.end(), '1');
+
+  auto expression = (a & b) | (c ^ ~d);
+  CHECK(expression.size() == size);
+  CHECK(expression.count() == expected_count);
+  CHECK(expression.any() == (expected_count != 0));
+  CHECK(expression.all() == (expected_count == size));
+
+  bitset result = expression;
+  CHECK_THAT(result, bitset_equals_string(expected));
+
+  bitset reused(size, false);
+  reused = (a & b) | (c ^ ~d);
+  CHECK_THAT(reused, bitset_equals_string(expected));
+
+  bitset moved = (bitset(a) & b) | (c ^ ~d);
+  CHECK_THAT(moved, bitset_equals_string(expected));
+
+  bitset compound(a);
+  compound &= b | ~a;
+  CHECK(compound == (a & b));
+  compound ^= compound & c;
+  CHECK(compound == (a & b & ~c));
+
+  bitset difference = andnot(a, b);
+  CHECK(difference == (a & ~b));
+  CHECK(andnot(a, c).count() == (a & ~c).count());
+  difference = a;
+  difference.andnot(b);
+  CHECK(difference == (a & ~b));
+  difference.andnot(c ^ d);
+  CHECK(difference == (a & ~b & ~(c ^ d)));
+
+  for (std::size_t i = 0; i < size; ++i) {
+    REQUIRE((a & b)[i] == (a[i] && b[i]));
+    REQUIRE(((a & b) | (c ^ ~d))[i] == (expected[i] == '1'));
+  }
+  CHECK(((a & b) | (c ^ ~d)).subview() == result);
+  CHECK(((a & b) | (c ^ ~d)).subview(size / 2) == result.subview(size / 2));
+  CHECK(and_count(a | b, c) == and_count(bitset(a | b), c));
+  CHECK(bitset::const_view(a ^ c) == bitset(a ^ c));
+}
+
+TEST_CASE("binary expressions over aligned operands") {
+  std::size_t size = GENERATE(0, 1, 64, 300, 1000);
+  CAPTURE(size);
+
+  const bitset a(random_bit_string(size, 41));
+  const bitset b(random_bit_string(size, 42));
+  std::string and_str(size, '0');
+  std::string andnot_str(size, '0');
+  for (std::size_t i = 0; i < size; ++i) {
+    and_str[i] = a[i] && b[i] ? '1' : '0';
+    andnot_str[i] = a[i] && !b[i] ? '1' : '0';
+  }
+  std::size_t and_ones = std::count(and_str.begin(), and_str.end(), '1');
+  std::size_t andnot_ones = std::count(andnot_str.begin(), andnot_str.end(), '1');
+
+  CHECK((a & b).count() == and_ones);
+  CHECK((a & b).any() == (and_ones != 0));
+  CHECK(andnot(a, b).count() == andnot_ones);
+  CHECK(andnot(a, b).any() == (andnot_ones != 0));
+  CHECK((a | b).count() == or_count(a, b));
+  CHECK((a ^ b).count() == xor_count(a, b));
+
+  bitset fresh = a & b;
+  CHECK_THAT(fresh, bitset_equals_string(and_str));
+
+  bitset lhs_target(a);
+  lhs_target = std::move(lhs_target) & b;
+  CHECK_THAT(lhs_target, bitset_equals_string(and_str));
+
+  bitset rhs_target(b);
+  rhs_target = a & std::move(rhs_target);
+  CHECK_THAT(rhs_target, bitset_equals_string(and_str));
+
+  bitset andnot_target(b);
+  andnot_target = andnot(a, std::move(andnot_target));
+  CHECK_THAT(andnot_target, bitset_equals_string(andnot_str));
+
+  bitset shifted(a);
+  if (size > 64) {
+    shifted = shifted.subview(64) & std::as_const(shifted).subview(0, size - 64);
+    CHECK(shifted == (a.subview(64) & a.subview(0, size - 64)));
+  }
+}
+
+TEST_CASE("find set and unset bits") {
+  std::string str = random_bit_string(300, 31);
+  for (std::size_t i = 70; i < 200; ++i) {
+    str[i] = '0';
+  }
+  const bitset bs(str);
+
+  std::size_t offset = GENERATE(0, 5, 64, 100);
+  std::size_t count = GENERATE(0, 1, 64, 150, 250);
+  CAPTURE(offset, count);
+
+  bitset::const_view view = bs.subview(offset, count);
+  std::string_view expected = std::string_view(str).substr(offset, count);
+
+  auto npos_if_missing = [](std::size_t pos) { return pos == std::string_view::npos ? bitset::npos : pos; };
+
+  CHECK(view.find_first() == npos_if_missing(expected.find('1')));
+  CHECK(view.find_first_zero() == npos_if_missing(expected.find('0')));
+  CHECK(view.find_last() == npos_if_missing(expected.rfind('1')));
+  CHECK(view.find_last_zero() == npos_if_missing(expected.rfind('0')));
+
+  for (std::size_t pos = 0; pos <= expected.size(); ++pos) {
+    CAPTURE(pos);
+    REQUIRE(view.find_next(pos) == npos_if_missing(expected.find('1', pos + 1)));
+    REQUIRE(view.find_next_zero(pos) == npos_if_missing(expected.find('0', pos + 1)));
+    std::size_t prev = (pos == 0) ? std::string_view::npos : expected.substr(0, pos).rfind('1');
+    std::size_t prev_zero = (pos == 0) ? std::string_view::npos : expected.substr(0, pos).rfind('0');
+    REQUIRE(view.find_prev(pos) == npos_if_missing(prev));
+    REQUIRE(view.find_prev_zero(pos) == npos_if_missing(prev_zero));
+  }
+
+  if (offset == 0 && count == 250) {
+    CHECK(bs.find_first() == npos_if_missing(std::string_view(str).find('1')));
+    CHECK(bs.find_next(69) == npos_if_missing(std::string_view(str).find('1', 70)));
+    CHECK(bs.find_prev(200) == npos_if_missing(std::string_view(str).substr(0, 200).rfind('1')));
+    CHECK(bs.find_last_zero() == npos_if_missing(std::string_view(str).rfind('0')));
+  }
+}
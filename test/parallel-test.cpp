@@ -0,0 +1,96 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("parallel operations agree with the serial ones") {
+  std::size_t threads = GENERATE(1, 3, 8);
+  std::size_t size = GENERATE(0, 100, 5000, 300000);
+  std::size_t offset = GENERATE(0, 5, 700);
+  CAPTURE(threads, size, offset);
+  parallel_policy policy{.threads = threads, .min_chunk_bits = 1024};
+
+  bitset lhs(random_bit_string(size + offset, 1));
+  bitset rhs(random_bit_string(size + offset, 2));
+  bitset::view dst = lhs.subview(offset);
+  bitset::const_view src = std::as_const(rhs).subview(offset);
+
+  SECTION("assignments") {
+    bitset expected(dst);
+    parallel_and_assign(policy, dst, src);
+    expected.subview() &= src;
+    CHECK(dst == expected);
+    parallel_or_assign(policy, dst, src);
+    expected.subview() |= src;
+    CHECK(dst == expected);
+    parallel_xor_assign(policy, dst, src);
+    expected.subview() ^= src;
+    CHECK(dst == expected);
+    parallel_flip(policy, dst);
+    expected.subview().flip();
+    CHECK(dst == expected);
+    CHECK(lhs.subview(0, offset) == bitset(random_bit_string(offset + size, 1)).subview(0, offset));
+  }
+
+  SECTION("reductions") {
+    CHECK(parallel_count(policy, dst) == dst.count());
+    CHECK(parallel_any(policy, dst) == dst.any());
+    CHECK(parallel_all(policy, dst) == dst.all());
+    CHECK(parallel_equal(policy, dst, src) == (dst == src));
+    CHECK(parallel_equal(policy, dst, dst));
+
+    dst.reset();
+    CHECK(parallel_count(policy, dst) == 0);
+    CHECK_FALSE(parallel_any(policy, dst));
+    if (size != 0) {
+      dst[size - 1] = true;
+      CHECK(parallel_any(policy, dst));
+      CHECK_FALSE(parallel_equal(policy, dst, bitset(size, false)));
+    }
+
+    dst.set();
+    CHECK(parallel_all(policy, dst));
+    CHECK(parallel_count(policy, dst) == size);
+    if (size != 0) {
+      dst[size / 2] = false;
+      CHECK_FALSE(parallel_all(policy, dst));
+    }
+  }
+}
+
+TEST_CASE("parallel operations on a large bitset") {
+  bitset bits(random_bit_string(3000000, 3));
+  bitset other(bits);
+  CHECK(parallel_count(parallel, bits) == bits.count());
+  CHECK(parallel_equal(parallel, bits, other));
+  parallel_flip(parallel, other);
+  CHECK(parallel_count(parallel, other) == bits.size() - bits.count());
+  parallel_xor_assign(parallel, other, bits);
+  CHECK(parallel_all(parallel, other));
+}
+
+TEST_CASE("parallel operations from several threads at once") {
+  const bitset bits(random_bit_string(200000, 4));
+  parallel_policy policy{.threads = 4, .min_chunk_bits = 1024};
+  std::vector<std::size_t> counts(6);
+  std::vector<std::thread> callers;
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    callers.emplace_back([&, i] {
+      for (int repeat = 0; repeat < 20; ++repeat) {
+        counts[i] = parallel_count(policy, bits);
+      }
+    });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  for (std::size_t count : counts) {
+    CHECK(count == bits.count());
+  }
+}
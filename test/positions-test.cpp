@@ -0,0 +1,72 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
+
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::size_t> positions_of(std::string_view str, char bit) {
+  std::vector<std::size_t> result;
+  for (std::size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == bit) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("ones and zeros are forward ranges") {
+  STATIC_CHECK(std::ranges::forward_range<decltype(std::declval<const bitset&>().ones())>);
+  STATIC_CHECK(std::ranges::forward_range<decltype(std::declval<const bitset&>().zeros())>);
+  STATIC_CHECK(std::ranges::view<decltype(std::declval<bitset::const_view>().ones())>);
+  STATIC_CHECK(std::ranges::borrowed_range<decltype(std::declval<bitset::view>().zeros())>);
+}
+
+TEST_CASE("ones and zeros of a bitset") {
+  SECTION("empty") {
+    const bitset bs;
+    CHECK(bs.ones().empty());
+    CHECK(bs.zeros().empty());
+  }
+
+  SECTION("sparse") {
+    bitset bs(1000, false);
+    std::vector<std::size_t> expected = {0, 63, 64, 500, 999};
+    for (std::size_t pos : expected) {
+      bs[pos] = true;
+    }
+    CHECK_THAT(bs.ones(), Catch::Matchers::RangeEquals(expected));
+
+    bs.flip();
+    CHECK_THAT(bs.zeros(), Catch::Matchers::RangeEquals(expected));
+  }
+}
+
+TEST_CASE("ones and zeros of a subview") {
+  std::string str = random_bit_string(300, 41);
+  const bitset bs(str);
+
+  std::size_t offset = GENERATE(0, 1, 64, 100, 300);
+  std::size_t count = GENERATE(0, 1, 63, 64, 200);
+  CAPTURE(offset, count);
+
+  bitset::const_view view = bs.subview(offset, count);
+  std::string_view expected = std::string_view(str).substr(std::min(offset, str.size()), count);
+
+  CHECK_THAT(view.ones(), Catch::Matchers::RangeEquals(positions_of(expected, '1')));
+  CHECK_THAT(view.zeros(), Catch::Matchers::RangeEquals(positions_of(expected, '0')));
+}
+
+TEST_CASE("ones compose with range adaptors") {
+  const bitset bs("0110010001");
+  auto doubled = bs.ones() | std::views::take(3) | std::views::transform([](std::size_t pos) { return pos * 2; });
+  CHECK_THAT(doubled, Catch::Matchers::RangeEquals(std::vector<std::size_t>{2, 4, 10}));
+}
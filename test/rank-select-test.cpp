@@ -0,0 +1,58 @@
+#include "bitset-rank-select.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("rank and select agree with a linear scan") {
+  std::size_t size = GENERATE(0, 1, 64, 511, 512, 513, 20000);
+  std::size_t offset = GENERATE(0, 3, 64);
+  CAPTURE(size, offset);
+
+  std::string str = random_bit_string(size + offset, 71);
+  if (size > 10000) {
+    for (std::size_t i = 2000; i < 9000; ++i) {
+      str[i] = '0';
+    }
+  }
+  const bitset bs(str);
+  bitset::const_view view = bs.subview(offset);
+  bitset_rank_select index(view);
+
+  std::vector<std::size_t> ones;
+  std::size_t rank = 0;
+  for (std::size_t pos = 0; pos < view.size(); ++pos) {
+    REQUIRE(index.rank1(pos) == rank);
+    REQUIRE(index.rank0(pos) == pos - rank);
+    if (str[offset + pos] == '1') {
+      ones.push_back(pos);
+      ++rank;
+    }
+  }
+  CHECK(index.rank1(view.size()) == rank);
+  CHECK(index.count() == ones.size());
+
+  for (std::size_t i = 0; i < ones.size(); ++i) {
+    CAPTURE(i);
+    REQUIRE(index.select1(i) == ones[i]);
+  }
+  CHECK(index.select1(ones.size()) == bitset_rank_select::npos);
+}
+
+TEST_CASE("select over all-ones and all-zeros bitsets") {
+  const bitset ones(10000, true);
+  bitset_rank_select ones_index(ones);
+  for (std::size_t i = 0; i < ones.size(); i += 37) {
+    REQUIRE(ones_index.select1(i) == i);
+  }
+
+  const bitset zeros(10000, false);
+  bitset_rank_select zeros_index(zeros);
+  CHECK(zeros_index.count() == 0);
+  CHECK(zeros_index.rank1(5000) == 0);
+  CHECK(zeros_index.select1(0) == bitset_rank_select::npos);
+}
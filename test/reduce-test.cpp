@@ -0,0 +1,71 @@
+#include "bitset-reduce.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("n-ary reductions agree with a per-bit reference") {
+  std::size_t inputs = GENERATE(1, 2, 5, 20);
+  std::size_t size = GENERATE(0, 1, 64, 1000, 40000);
+  std::size_t offset = GENERATE(0, 7);
+  CAPTURE(inputs, size, offset);
+
+  std::vector<std::string> strs;
+  std::vector<bitset> storage;
+  std::vector<bitset::const_view> views;
+  for (std::size_t i = 0; i < inputs; ++i) {
+    strs.push_back(random_bit_string(size + offset, static_cast<unsigned>(i + 10)));
+    // Make the AND non-trivial: the first half of every input is mostly ones.
+    for (std::size_t pos = 0; pos < (size + offset) / 2; ++pos) {
+      if (pos % 5 != i % 5) {
+        strs.back()[pos] = '1';
+      }
+    }
+    storage.emplace_back(strs.back());
+  }
+  for (std::size_t i = 0; i < inputs; ++i) {
+    views.push_back(storage[i].subview(i % 2 == 0 ? offset : 0, size));
+  }
+
+  auto bit = [&](std::size_t input, std::size_t pos) {
+    return strs[input][(input % 2 == 0 ? offset : 0) + pos] == '1';
+  };
+
+  std::string expected_and(size, '0');
+  std::string expected_or(size, '0');
+  std::string expected_xor(size, '0');
+  std::vector<std::size_t> counts(size, 0);
+  for (std::size_t pos = 0; pos < size; ++pos) {
+    for (std::size_t i = 0; i < inputs; ++i) {
+      counts[pos] += bit(i, pos);
+    }
+    expected_and[pos] = counts[pos] == inputs ? '1' : '0';
+    expected_or[pos] = counts[pos] != 0 ? '1' : '0';
+    expected_xor[pos] = counts[pos] % 2 == 1 ? '1' : '0';
+  }
+
+  CHECK_THAT(reduce_and(views), bitset_equals_string(expected_and));
+  CHECK_THAT(reduce_or(views), bitset_equals_string(expected_or));
+  CHECK_THAT(reduce_xor(views), bitset_equals_string(expected_xor));
+
+  for (std::size_t threshold = 0; threshold <= inputs + 1; ++threshold) {
+    CAPTURE(threshold);
+    std::string expected(size, '0');
+    for (std::size_t pos = 0; pos < size; ++pos) {
+      expected[pos] = counts[pos] >= threshold ? '1' : '0';
+    }
+    CHECK_THAT(reduce_at_least(views, threshold), bitset_equals_string(expected));
+  }
+}
+
+TEST_CASE("reductions over no inputs") {
+  CHECK(reduce_and({}).empty());
+  CHECK(reduce_or({}).empty());
+  CHECK(reduce_xor({}).empty());
+  CHECK(reduce_at_least({}, 0).empty());
+  CHECK(reduce_at_least({}, 1).empty());
+}
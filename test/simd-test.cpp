@@ -0,0 +1,290 @@
+#include "bitset-simd.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct simd_level_guard {
+  explicit simd_level_guard(simd_level level)
+      : _previous(active_simd_level()) {
+    force_simd_level(level);
+  }
+
+  ~simd_level_guard() {
+    force_simd_level(_previous);
+  }
+
+private:
+  simd_level _previous;
+};
+
+} // namespace
+
+TEST_CASE("forced simd level is clamped to the detected one") {
+  simd_level_guard guard(simd_level::avx512);
+  CHECK(active_simd_level() == detected_simd_level());
+
+  force_simd_level(simd_level::scalar);
+  CHECK(active_simd_level() == simd_level::scalar);
+}
+
+TEST_CASE("simd kernels agree with scalar reference") {
+  simd_level level = GENERATE(simd_level::scalar, simd_level::avx2, simd_level::avx512);
+  if (level > detected_simd_level()) {
+    SKIP("simd level is not supported");
+  }
+  simd_level_guard guard(level);
+  CAPTURE(static_cast<int>(level));
+
+  std::size_t size = GENERATE(0, 64, 255, 512, 1000, 4096 + 17);
+  CAPTURE(size);
+
+  std::string lhs_str = random_bit_string(size, 1);
+  std::string rhs_str = random_bit_string(size, 2);
+  bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+
+  auto combine = [&](auto operation) {
+    std::string result = lhs_str;
+    for (std::size_t i = 0; i < size; ++i) {
+      result[i] = operation(lhs_str[i] == '1', rhs_str[i] == '1') ? '1' : '0';
+    }
+    return result;
+  };
+
+  SECTION("bitwise and") {
+    lhs &= rhs;
+    CHECK_THAT(lhs, bitset_equals_string(combine([](bool a, bool b) { return a && b; })));
+  }
+
+  SECTION("bitwise or") {
+    lhs |= rhs;
+    CHECK_THAT(lhs, bitset_equals_string(combine([](bool a, bool b) { return a || b; })));
+  }
+
+  SECTION("bitwise xor") {
+    lhs ^= rhs;
+    CHECK_THAT(lhs, bitset_equals_string(combine([](bool a, bool b) { return a != b; })));
+  }
+
+  SECTION("andnot") {
+    lhs.andnot(rhs);
+    CHECK_THAT(lhs, bitset_equals_string(combine([](bool a, bool b) { return a && !b; })));
+  }
+
+  SECTION("flip") {
+    lhs.flip();
+    CHECK_THAT(lhs, bitset_equals_string(combine([](bool a, bool) { return !a; })));
+  }
+
+  SECTION("count") {
+    CHECK(lhs.count() == static_cast<std::size_t>(std::ranges::count(lhs_str, '1')));
+  }
+
+  SECTION("comparison") {
+    CHECK(lhs == bitset(lhs_str));
+    if (size != 0) {
+      bitset other(lhs_str);
+      other[size - 1].flip();
+      CHECK(lhs != other);
+      other[size - 1].flip();
+      other[size / 2].flip();
+      CHECK(lhs != other);
+    }
+  }
+
+  SECTION("all and any") {
+    CHECK(bitset(size, true).all());
+    CHECK(!bitset(size, false).any());
+    if (size != 0) {
+      bitset bs(size, true);
+      bs[size - 1] = false;
+      CHECK_FALSE(bs.all());
+      bs.reset();
+      bs[size / 3] = true;
+      CHECK(bs.any());
+    }
+  }
+}
+
+TEST_CASE("bulk popcount over unaligned views") {
+  simd_level level = GENERATE(simd_level::scalar, simd_level::avx2, simd_level::avx512);
+  if (level > detected_simd_level()) {
+    SKIP("simd level is not supported");
+  }
+  simd_level_guard guard(level);
+  CAPTURE(static_cast<int>(level));
+
+  std::string str = random_bit_string(20000, 3);
+  const bitset bs(str);
+
+  std::size_t offset = GENERATE(0, 1, 63, 64, 129);
+  std::size_t count = GENERATE(0, 10, 4096, 8191, 19000);
+  CAPTURE(offset, count);
+
+  auto expected = std::count(str.begin() + offset, str.begin() + offset + count, '1');
+  CHECK(bs.subview(offset, count).count() == static_cast<std::size_t>(expected));
+}
+
+TEST_CASE("decoding set bits to indices") {
+  simd_level level = GENERATE(simd_level::scalar, simd_level::avx2, simd_level::avx512);
+  if (level > detected_simd_level()) {
+    SKIP("simd level is not supported");
+  }
+  simd_level_guard guard(level);
+  CAPTURE(static_cast<int>(level));
+
+  std::string str = random_bit_string(3000, 51);
+  for (std::size_t i = 1000; i < 2000; ++i) {
+    str[i] = (i % 97 == 0) ? '1' : '0';
+  }
+  const bitset bs(str);
+
+  std::size_t offset = GENERATE(0, 1, 64, 999);
+  std::size_t count = GENERATE(0, 5, 64, 1500, 2000);
+  CAPTURE(offset, count);
+
+  std::vector<uint64_t> expected;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (str[offset + i] == '1') {
+      expected.push_back(i);
+    }
+  }
+
+  bitset::const_view view = bs.subview(offset, count);
+  std::vector<uint64_t> indices_64 = to_indices64(view);
+  std::vector<uint32_t> indices_32 = to_indices(view);
+
+  CHECK(indices_64 == expected);
+  REQUIRE(indices_32.size() == expected.size());
+  CHECK(std::equal(indices_32.begin(), indices_32.end(), expected.begin()));
+
+  std::vector<uint32_t> buffer(expected.size() + 1, 12345);
+  CHECK(to_indices(view, buffer.data()) == expected.size());
+  CHECK(buffer.back() == 12345);
+}
+
+TEST_CASE("fused counts and subset tests") {
+  simd_level level = GENERATE(simd_level::scalar, simd_level::avx2, simd_level::avx512);
+  if (level > detected_simd_level()) {
+    SKIP("simd level is not supported");
+  }
+  simd_level_guard guard(level);
+  CAPTURE(static_cast<int>(level));
+
+  std::string lhs_str = random_bit_string(6000, 61);
+  std::string rhs_str = random_bit_string(6000, 62);
+  const bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+
+  std::size_t lhs_offset = GENERATE(0, 3, 64);
+  std::size_t rhs_offset = GENERATE(0, 64, 100);
+  std::size_t count = GENERATE(0, 1, 64, 777, 4096 + 5);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  bitset::const_view a = lhs.subview(lhs_offset, count);
+  bitset::const_view b = rhs.subview(rhs_offset, count);
+
+  std::size_t expected_and = 0;
+  std::size_t expected_or = 0;
+  std::size_t expected_xor = 0;
+  std::size_t expected_andnot = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    bool x = lhs_str[lhs_offset + i] == '1';
+    bool y = rhs_str[rhs_offset + i] == '1';
+    expected_and += x && y;
+    expected_or += x || y;
+    expected_xor += x != y;
+    expected_andnot += x && !y;
+  }
+
+  CHECK(and_count(a, b) == expected_and);
+  CHECK(or_count(a, b) == expected_or);
+  CHECK(xor_count(a, b) == expected_xor);
+  CHECK(andnot_count(a, b) == expected_andnot);
+  CHECK(intersects(a, b) == (expected_and != 0));
+  CHECK(is_subset_of(a, b) == (expected_andnot == 0));
+
+  bitset subset(a);
+  subset &= b;
+  CHECK(is_subset_of(subset, b));
+  CHECK(is_subset_of(subset, a));
+  if (count != 0) {
+    bitset single(count, false);
+    single[count - 1] = true;
+    bitset rest = ~single;
+    CHECK_FALSE(intersects(single, rest));
+    CHECK_FALSE(is_subset_of(single, rest));
+    CHECK(is_subset_of(rest, rest));
+  }
+}
+
+TEST_CASE("ternary logic over three views") {
+  simd_level level = GENERATE(simd_level::scalar, simd_level::avx2, simd_level::avx512);
+  if (level > detected_simd_level()) {
+    SKIP("simd level is not supported");
+  }
+  simd_level_guard guard(level);
+  CAPTURE(static_cast<int>(level));
+
+  std::size_t dst_offset = GENERATE(0, 5);
+  std::size_t input_offset = GENERATE(0, 64, 70);
+  std::size_t count = GENERATE(0, 1, 64, 700, 1029);
+  CAPTURE(dst_offset, input_offset, count);
+
+  std::string a_str = random_bit_string(1200, 71);
+  std::string b_str = random_bit_string(1200, 72);
+  std::string c_str = random_bit_string(1200, 73);
+  std::string dst_str = random_bit_string(1200, 74);
+  const bitset a(a_str);
+  const bitset b(b_str);
+  const bitset c(c_str);
+
+  auto check = [&]<uint8_t Function>() {
+    CAPTURE(static_cast<int>(Function));
+    bitset dst(dst_str);
+    ternary<Function>(
+        dst.subview(dst_offset, count),
+        a.subview(input_offset, count),
+        b.subview(0, count),
+        c.subview(input_offset, count)
+    );
+    std::string expected = dst_str;
+    for (std::size_t i = 0; i < count; ++i) {
+      unsigned index = (a_str[input_offset + i] - '0') << 2 | (b_str[i] - '0') << 1 | (c_str[input_offset + i] - '0');
+      expected[dst_offset + i] = ((Function >> index) & 1) ? '1' : '0';
+    }
+    CHECK_THAT(dst, bitset_equals_string(expected));
+  };
+
+  check.operator()<TERNARY_A & (TERNARY_B | static_cast<uint8_t>(~TERNARY_C))>();
+  check.operator()<TERNARY_A ^ TERNARY_B ^ TERNARY_C>();
+  check.operator()<(TERNARY_A & TERNARY_B) | (TERNARY_A & TERNARY_C) | (TERNARY_B & TERNARY_C)>();
+  check.operator()<(TERNARY_A & TERNARY_B) | (static_cast<uint8_t>(~TERNARY_A) & TERNARY_C)>();
+  check.operator()<0x00>();
+  check.operator()<0xff>();
+
+  bitset dst(dst_str);
+  dst.subview(dst_offset, count)
+      .apply(
+          [](uint64_t x, uint64_t y, uint64_t z) { return x & (y | ~z); },
+          a.subview(input_offset, count),
+          b.subview(0, count),
+          c.subview(input_offset, count)
+      );
+  bitset expected(dst_str);
+  ternary<TERNARY_A & (TERNARY_B | static_cast<uint8_t>(~TERNARY_C))>(
+      expected.subview(dst_offset, count),
+      a.subview(input_offset, count),
+      b.subview(0, count),
+      c.subview(input_offset, count)
+  );
+  CHECK(dst == expected);
+}
@@ -0,0 +1,82 @@
+#include "slot-allocator.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("slot allocator hands out every slot once") {
+  std::size_t capacity = GENERATE(0, 1, 63, 64, 65, 5000);
+  CAPTURE(capacity);
+  slot_allocator slots(capacity);
+  CHECK(slots.capacity() == capacity);
+  CHECK(slots.in_use() == 0);
+
+  std::set<std::size_t> acquired;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    std::size_t slot = slots.acquire();
+    REQUIRE(slot < capacity);
+    CHECK(acquired.insert(slot).second);
+    CHECK(slots.is_acquired(slot));
+  }
+  CHECK(slots.acquire() == slot_allocator::npos);
+  CHECK(slots.in_use() == capacity);
+
+  if (capacity > 0) {
+    std::size_t slot = capacity / 2;
+    slots.release(slot);
+    CHECK_FALSE(slots.is_acquired(slot));
+    CHECK(slots.in_use() == capacity - 1);
+    CHECK(slots.acquire() == slot);
+    CHECK(slots.acquire() == slot_allocator::npos);
+  }
+}
+
+TEST_CASE("slot allocator under contention") {
+  constexpr std::size_t THREADS = 8;
+  constexpr std::size_t CAPACITY = 1000;
+  constexpr std::size_t ROUNDS = 20000;
+  slot_allocator slots(CAPACITY);
+  std::vector<std::atomic<int>> owners(CAPACITY);
+  std::atomic<bool> conflict = false;
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&] {
+      std::vector<std::size_t> held;
+      for (std::size_t round = 0; round < ROUNDS; ++round) {
+        if (held.size() < 200 && round % 3 != 2) {
+          std::size_t slot = slots.acquire();
+          if (slot != slot_allocator::npos) {
+            if (owners[slot].fetch_add(1) != 0) {
+              conflict = true;
+            }
+            held.push_back(slot);
+          }
+        } else if (!held.empty()) {
+          owners[held.back()].fetch_sub(1);
+          slots.release(held.back());
+          held.pop_back();
+        }
+      }
+      for (std::size_t slot : held) {
+        owners[slot].fetch_sub(1);
+        slots.release(slot);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  CHECK_FALSE(conflict.load());
+  CHECK(slots.in_use() == 0);
+  for (std::size_t i = 0; i < CAPACITY; ++i) {
+    CHECK(slots.acquire() != slot_allocator::npos);
+  }
+  CHECK(slots.acquire() == slot_allocator::npos);
+}
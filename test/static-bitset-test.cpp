@@ -0,0 +1,92 @@
+#include "bitset.h"
+#include "static-bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr static_bitset<100> make_mask() {
+  static_bitset<100> result;
+  for (std::size_t i = 0; i < 100; i += 7) {
+    result.set(i);
+  }
+  return result;
+}
+
+constexpr std::size_t sum_of_positions(const static_bitset<100>& bits) {
+  std::size_t result = 0;
+  for (std::size_t pos : bits) {
+    result += pos;
+  }
+  return result;
+}
+
+std::size_t count_view(const bitset::const_view& bits) {
+  return bits.count();
+}
+
+} // namespace
+
+TEST_CASE("static bitset is usable in constant expressions") {
+  constexpr static_bitset<100> mask = make_mask();
+  static_assert(mask.count() == 15);
+  static_assert(mask.test(98) && !mask.test(99));
+  static_assert(mask.find_first() == 0 && mask.find_next(0) == 7 && mask.find_next(98) == static_bitset<100>::npos);
+  static_assert(sum_of_positions(mask) == 7 * (14 * 15 / 2));
+  static_assert((~mask).count() == 85);
+  static_assert((mask & ~mask).count() == 0 && !(mask & ~mask).any());
+  static_assert((mask | ~mask).all());
+  static_assert((mask ^ mask) == static_bitset<100>());
+  static_assert(andnot(mask, mask) == static_bitset<100>());
+  static_assert((~static_bitset<100>()).all());
+  static_assert([] {
+    static_bitset<100> all_set;
+    return all_set.set().count();
+  }() == 100);
+  static_assert(static_bitset<5>("10110").count() == 3);
+  static_assert(static_bitset<5, uint8_t>("10110").words()[0] == 0b01101);
+  static_assert(static_bitset<0>().all() && !static_bitset<0>().any());
+  static_assert((~static_bitset<128>()).all());
+  SUCCEED();
+}
+
+TEST_CASE("static bitset agrees with bitset") {
+  std::string str = random_bit_string(200, 12);
+  static_bitset<200> bits(str);
+  bitset expected(str);
+  CHECK(bits.subview() == expected);
+  CHECK(bits.count() == expected.count());
+  CHECK(count_view(bits) == expected.count());
+
+  std::vector<std::size_t> positions(bits.begin(), bits.end());
+  std::vector<std::size_t> expected_positions;
+  for (std::size_t pos = expected.find_first(); pos != bitset::npos; pos = expected.find_next(pos)) {
+    expected_positions.push_back(pos);
+  }
+  CHECK(positions == expected_positions);
+
+  static_bitset<200> other(random_bit_string(200, 13));
+  CHECK((bits & other).subview() == bitset(expected & other.subview()));
+  CHECK((bits | other).subview() == bitset(expected | other.subview()));
+  CHECK((bits ^ other).subview() == bitset(expected ^ other.subview()));
+  CHECK((~bits).subview() == bitset(~expected));
+
+  bits.subview(10, 50).set();
+  expected.subview(10, 50).set();
+  CHECK(bits.subview() == expected);
+  CHECK(bits.count() == expected.count());
+}
+
+TEST_CASE("static bitset with narrow words") {
+  std::string str = random_bit_string(21, 14);
+  static_bitset<21, uint8_t> bits(str);
+  CHECK(to_string(bits.subview()) == str);
+  CHECK(bits.flip().count() == 21 - bitset(str).count());
+  CHECK(bits.words()[2] >> 5 == 0);
+}
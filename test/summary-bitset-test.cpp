@@ -0,0 +1,101 @@
+#include "bitset.h"
+#include "summary-bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+
+void check_against(const summary_bitset& actual, const bitset& expected) {
+  REQUIRE(actual.bits() == expected);
+  CHECK(actual.count() == expected.count());
+  CHECK(actual.any() == expected.any());
+  CHECK(actual.all() == expected.all());
+  CHECK(actual.find_first() == expected.find_first());
+  CHECK(actual.find_first_zero() == expected.find_first_zero());
+  for (std::size_t pos = 0; pos < expected.size(); pos += 37) {
+    CHECK(actual.find_next(pos) == expected.find_next(pos));
+    CHECK(actual.find_next_zero(pos) == expected.find_next_zero(pos));
+  }
+  std::vector<std::size_t> positions(actual.begin(), actual.end());
+  std::vector<std::size_t> expected_positions;
+  for (std::size_t pos = expected.find_first(); pos != bitset::npos; pos = expected.find_next(pos)) {
+    expected_positions.push_back(pos);
+  }
+  CHECK(positions == expected_positions);
+}
+
+} // namespace
+
+TEST_CASE("summary bitset agrees with bitset") {
+  std::size_t size = GENERATE(0, 1, 64, 100, 4096, 10000);
+  CAPTURE(size);
+  bitset expected(size, false);
+  summary_bitset actual(size);
+  check_against(actual, expected);
+
+  std::mt19937 rng(17);
+  SECTION("single bits in a sparse set") {
+    for (std::size_t i = 0; i < 50 && size != 0; ++i) {
+      std::size_t pos = rng() % size;
+      actual.set(pos);
+      expected[pos] = true;
+      check_against(actual, expected);
+      if (i % 3 == 0) {
+        actual.reset(pos);
+        expected[pos] = false;
+      } else if (i % 3 == 1) {
+        actual.flip(pos);
+        expected[pos].flip();
+      }
+    }
+    check_against(actual, expected);
+  }
+
+  SECTION("single bits in a dense set") {
+    actual.set();
+    expected.set();
+    check_against(actual, expected);
+    for (std::size_t i = 0; i < 50 && size != 0; ++i) {
+      std::size_t pos = rng() % size;
+      actual.reset(pos);
+      expected[pos] = false;
+      check_against(actual, expected);
+    }
+    actual.flip();
+    expected.flip();
+    check_against(actual, expected);
+    actual.reset();
+    expected.reset();
+    check_against(actual, expected);
+  }
+
+  SECTION("whole-set operations") {
+    bitset other(random_bit_string(size, 3));
+    actual |= other;
+    expected |= other;
+    check_against(actual, expected);
+    bitset mask(random_bit_string(size, 4));
+    actual &= mask;
+    expected &= mask;
+    check_against(actual, expected);
+    actual ^= other;
+    expected ^= other;
+    check_against(actual, expected);
+    actual.andnot(mask);
+    expected.andnot(mask);
+    check_against(actual, expected);
+    CHECK(summary_bitset(expected.subview()) == actual);
+  }
+}
+
+TEST_CASE("summary bitset from an unaligned view") {
+  bitset source(random_bit_string(5000, 9));
+  summary_bitset bits(source.subview(13, 4000));
+  check_against(bits, bitset(source.subview(13, 4000)));
+}
@@ -1,5 +1,6 @@
 #include "test-helpers.h"
 
+#include <random>
 #include <ranges>
 
 std::vector<bool> string_to_bools(std::string_view str) {
@@ -7,6 +8,15 @@ std::vector<bool> string_to_bools(std::string_view str) {
   return {view.begin(), view.end()};
 }
 
+std::string random_bit_string(std::size_t size, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::string result(size, '0');
+  for (char& c : result) {
+    c = static_cast<char>('0' + gen() % 2);
+  }
+  return result;
+}
+
 bitset_equals_string::bitset_equals_string(std::string_view expected)
     : _expected(expected) {}
 
@@ -4,10 +4,13 @@
 
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <string>
 #include <vector>
 
 std::vector<bool> string_to_bools(std::string_view str);
 
+std::string random_bit_string(std::size_t size, unsigned seed);
+
 struct bitset_equals_string : Catch::Matchers::MatcherBase<bitset> {
   explicit bitset_equals_string(std::string_view expected);
 
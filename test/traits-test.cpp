@@ -9,6 +9,8 @@ TEST_CASE("member types") {
     STATIC_CHECK(std::is_same_v<bitset::value_type, bool>);
     STATIC_CHECK_FALSE(std::is_same_v<bitset::reference, bool>);
     STATIC_CHECK(std::numeric_limits<bitset::word_type>::digits >= 32);
+    STATIC_CHECK(std::is_nothrow_move_constructible_v<bitset>);
+    STATIC_CHECK(std::is_nothrow_move_assignable_v<bitset>);
   }
 
   SECTION("iterators") {